@@ -0,0 +1,59 @@
+import { Cached{{Feature}}DataSource } from '../../../Features/{{feature}}/data/datasources/{{feature}}.cached.datasource';
+import { {{Feature}}DataSource } from '../../../Features/{{feature}}/data/datasources/{{feature}}.datasource';
+import { MemoryCache, ReadThroughCache } from '../../../Core/cache/cache';
+import { Ok } from '../../../Core/result/result';
+import { {{Feature}} } from '../../../Features/{{feature}}/domain/entity/{{feature}}.entity';
+
+describe('Cached{{Feature}}DataSource', () => {
+  let dataSource: jest.Mocked<{{Feature}}DataSource>;
+  let cached: Cached{{Feature}}DataSource;
+  const dto = {{sample}};
+  const {{feature}} = new {{Feature}}('123', {{dto_args}});
+
+  beforeEach(() => {
+    dataSource = {
+      create: jest.fn(),
+      createMany: jest.fn(),
+      findById: jest.fn().mockResolvedValue(Ok({{feature}})),
+      findPage: jest.fn(),
+      update: jest.fn(),
+      delete: jest.fn(),
+    } as unknown as jest.Mocked<{{Feature}}DataSource>;
+    cached = new Cached{{Feature}}DataSource(dataSource, new ReadThroughCache(new MemoryCache<{{Feature}}>(100, 60000)));
+  });
+
+  it('should load concurrent misses for the same id once', async () => {
+    const [first, second] = await Promise.all([cached.findById('123'), cached.findById('123')]);
+
+    expect(first.unwrap()).toEqual({{feature}});
+    expect(second.unwrap()).toEqual({{feature}});
+    expect(dataSource.findById).toHaveBeenCalledTimes(1);
+  });
+
+  it('should serve repeated reads from the cache', async () => {
+    await cached.findById('123');
+    await cached.findById('123');
+
+    expect(dataSource.findById).toHaveBeenCalledTimes(1);
+  });
+
+  it('should write the updated entity through to the cache', async () => {
+    const updated = new {{Feature}}('123', {{dto_args}}, 1);
+    dataSource.update.mockResolvedValue(Ok(updated));
+    await cached.findById('123');
+    await cached.update('123', {}, 0);
+
+    expect(dataSource.update).toHaveBeenCalledWith('123', {}, 0);
+    expect((await cached.findById('123')).unwrap()).toEqual(updated);
+    expect(dataSource.findById).toHaveBeenCalledTimes(1);
+  });
+
+  it('should invalidate the cached entry when an update finds nothing to change', async () => {
+    dataSource.update.mockResolvedValue(Ok(null));
+    await cached.findById('123');
+    await cached.update('123', {}, 0);
+    await cached.findById('123');
+
+    expect(dataSource.findById).toHaveBeenCalledTimes(2);
+  });
+});
@@ -0,0 +1,47 @@
+import { injectable, inject } from 'tsyringe';
+import { {{Feature}} } from '../../domain/entity/{{feature}}.entity';
+import { {{Feature}}Page, {{Feature}}Changes } from '../../domain/repositories/{{feature}}.repository.interface';
+import { {{Feature}}DataSource } from './{{feature}}.datasource';
+import { ReadThroughCache } from '../../../../Core/cache/cache';
+import { Result } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';
+
+// Read-through cache in front of the Mongo datasource: findById is served from the cache, updates write the new
+// entity through and deletes invalidate it. Creates leave it alone: a new id cannot have been cached yet
+@injectable()
+export class Cached{{Feature}}DataSource implements {{Feature}}DataSource {
+  constructor(
+    @inject('{{Feature}}MongoDataSource') private dataSource: {{Feature}}DataSource,
+    @inject('{{Feature}}Cache') private cache: ReadThroughCache<{{Feature}}>,
+  ) {}
+
+  async create({{feature}}: {{Feature}}): Promise<Result<{{Feature}}, CustomError>> {
+    return await this.dataSource.create({{feature}});
+  }
+
+  async createMany({{feature}}List: {{Feature}}[]): Promise<Result<Result<{{Feature}}, CustomError>[], CustomError>> {
+    return await this.dataSource.createMany({{feature}}List);
+  }
+
+  async findById(id: string): Promise<Result<{{Feature}} | null, CustomError>> {
+    return await this.cache.get(id, () => this.dataSource.findById(id));
+  }
+
+  async findPage(cursor: string | null, limit: number): Promise<Result<{{Feature}}Page, CustomError>> {
+    return await this.dataSource.findPage(cursor, limit);
+  }
+
+  async update(id: string, changes: {{Feature}}Changes, expectedVersion?: number): Promise<Result<{{Feature}} | null, CustomError>> {
+    const result = await this.dataSource.update(id, changes, expectedVersion);
+    const updated = result.isOk() ? result.unwrap() : null;
+    if (updated !== null) await this.cache.put(id, updated);
+    else await this.cache.invalidate(id);
+    return result;
+  }
+
+  async delete(id: string, expectedVersion?: number): Promise<Result<boolean, CustomError>> {
+    const result = await this.dataSource.delete(id, expectedVersion);
+    await this.cache.invalidate(id);
+    return result;
+  }
+}
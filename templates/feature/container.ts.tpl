@@ -0,0 +1,21 @@
+import 'reflect-metadata';
+import { {{tsyringe_imports}} } from 'tsyringe';
+import { {{Feature}}Controller } from './delivery/controllers/{{feature}}.controller';
+import { Create{{Feature}}UseCase } from './domain/usecases/create-{{feature}}.usecase';
+import { CreateMany{{Feature}}UseCase } from './domain/usecases/create-many-{{feature}}.usecase';
+import { List{{Feature}}UseCase } from './domain/usecases/list-{{feature}}.usecase';
+import { Update{{Feature}}UseCase } from './domain/usecases/update-{{feature}}.usecase';
+import { Delete{{Feature}}UseCase } from './domain/usecases/delete-{{feature}}.usecase';
+import { {{Feature}}RepositoryImpl } from './data/repositories/{{feature}}.repository';
+import { {{Feature}}DataSource } from './data/datasources/{{feature}}.datasource';{{cache_imports}}
+
+{{di_register 'Create{Feature}UseCase' Create{Feature}UseCase}}
+{{di_register 'CreateMany{Feature}UseCase' CreateMany{Feature}UseCase}}
+{{di_register 'List{Feature}UseCase' List{Feature}UseCase}}
+{{di_register 'Update{Feature}UseCase' Update{Feature}UseCase}}
+{{di_register 'Delete{Feature}UseCase' Delete{Feature}UseCase}}
+{{di_register '{Feature}Repository' {Feature}RepositoryImpl}}
+{{datasource_registrations}}
+{{di_register {Feature}Controller {Feature}Controller}}
+
+export { container };
@@ -0,0 +1,162 @@
+import request from 'supertest';
+import express from 'express';
+import { container } from '../../../Features/{{feature}}/container';
+import { {{Feature}}Controller } from '../../../Features/{{feature}}/delivery/controllers/{{feature}}.controller';
+import { Create{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/create-{{feature}}.usecase';
+import { CreateMany{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/create-many-{{feature}}.usecase';
+import { List{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/list-{{feature}}.usecase';
+import { Update{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/update-{{feature}}.usecase';
+import { Delete{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/delete-{{feature}}.usecase';
+import { Result, Ok, Err } from '../../../Core/result/result';
+import { CustomError } from '../../../Core/error/custom-error';
+import { errorHandler } from '../../../Core/error/error-handler';
+import { {{Feature}} } from '../../../Features/{{feature}}/domain/entity/{{feature}}.entity';
+
+describe('{{Feature}}Controller', () => {
+  let app: express.Application;
+  let mockUseCase: jest.Mocked<Create{{Feature}}UseCase>;
+  let mockCreateManyUseCase: jest.Mocked<CreateMany{{Feature}}UseCase>;
+  let mockListUseCase: jest.Mocked<List{{Feature}}UseCase>;
+  let mockUpdateUseCase: jest.Mocked<Update{{Feature}}UseCase>;
+  let mockDeleteUseCase: jest.Mocked<Delete{{Feature}}UseCase>;
+
+  beforeEach(() => {
+    mockUseCase = {
+      execute: jest.fn(),
+    };
+    mockCreateManyUseCase = {
+      execute: jest.fn(),
+    };
+    mockListUseCase = {
+      execute: jest.fn(),
+    };
+    mockUpdateUseCase = {
+      execute: jest.fn(),
+    };
+    mockDeleteUseCase = {
+      execute: jest.fn(),
+    };
+    container.registerInstance('Create{{Feature}}UseCase', mockUseCase);
+    container.registerInstance('CreateMany{{Feature}}UseCase', mockCreateManyUseCase);
+    container.registerInstance('List{{Feature}}UseCase', mockListUseCase);
+    container.registerInstance('Update{{Feature}}UseCase', mockUpdateUseCase);
+    container.registerInstance('Delete{{Feature}}UseCase', mockDeleteUseCase);
+    const controller = container.resolve({{Feature}}Controller);
+    app = express();
+    app.use('/api/{{feature}}', controller.getRouter());
+    app.use(errorHandler);
+  });
+
+  afterEach(() => {
+    // Drops the mock and any cached instances but keeps the registrations from container.ts
+    container.clearInstances();
+  });
+
+  it('should create a {{feature}} and return 201', async () => {
+    const dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}});
+    mockUseCase.execute.mockResolvedValue(Ok({{feature}}));
+
+    const response = await request(app)
+      .post('/api/{{feature}}')
+      .send(dto)
+      .set('Accept', 'application/json');
+
+    expect(response.status).toBe(201);
+    expect(response.body).toEqual({
+      id: '123',
+      {{dto_props}}version: 0,
+    });
+    expect(mockUseCase.execute).toHaveBeenCalledWith(dto);
+  });
+
+  it('should return 400 for invalid input', async () => {
+    const invalidDto = {};
+
+    const response = await request(app)
+      .post('/api/{{feature}}')
+      .send(invalidDto)
+      .set('Accept', 'application/json');
+
+    expect(response.status).toBe(400);
+    expect(response.body.message).toContain('is required');
+  });
+
+  it('should report per-item results for a bulk create', async () => {
+    const dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}});
+    mockCreateManyUseCase.execute.mockResolvedValue(Ok([Ok({{feature}}), Err(new CustomError(409, 'Duplicate'))]));
+
+    const response = await request(app)
+      .post('/api/{{feature}}/bulk')
+      .send([dto, dto])
+      .set('Accept', 'application/json');
+
+    expect(response.status).toBe(207);
+    expect(response.body.inserted).toBe(1);
+    expect(response.body.failed).toBe(1);
+    expect(response.body.results[1]).toEqual({ kind: 'Err', error: { statusCode: 409, message: 'Duplicate' } });
+    expect(mockCreateManyUseCase.execute).toHaveBeenCalledWith([dto, dto]);
+  });
+
+  it('should import NDJSON records in batches and report rejected lines', async () => {
+    const dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}});
+    mockCreateManyUseCase.execute.mockResolvedValue(Ok([Ok({{feature}}), Ok({{feature}})]));
+
+    const response = await request(app)
+      .post('/api/{{feature}}/import')
+      .set('Content-Type', 'application/x-ndjson')
+      .send([JSON.stringify(dto), '{}', 'not json', JSON.stringify(dto)].join('\n'));
+
+    expect(response.status).toBe(207);
+    expect(response.body.received).toBe(4);
+    expect(response.body.inserted).toBe(2);
+    expect(response.body.failed).toBe(2);
+    expect(response.body.errors[1]).toEqual({ record: 3, message: 'invalid JSON' });
+    expect(mockCreateManyUseCase.execute).toHaveBeenCalledWith([dto, dto]);
+  });
+
+  it('should return a page and pass the cursor through', async () => {
+    const dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}});
+    mockListUseCase.execute.mockResolvedValue(Ok({ items: [{{feature}}], nextCursor: 'next' }));
+
+    const response = await request(app).get('/api/{{feature}}?cursor=abc&limit=5');
+
+    expect(response.status).toBe(200);
+    expect(response.body.nextCursor).toBe('next');
+    expect(mockListUseCase.execute).toHaveBeenCalledWith('abc', 5);
+  });
+
+  it('should update a {{feature}} with the If-Match version and return 200', async () => {
+    const dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}}, 4);
+    mockUpdateUseCase.execute.mockResolvedValue(Ok({{feature}}));
+
+    const response = await request(app)
+      .patch('/api/{{feature}}/123')
+      .set('If-Match', '"3"')
+      .send(dto);
+
+    expect(response.status).toBe(200);
+    expect(response.body.version).toBe(4);
+    expect(mockUpdateUseCase.execute).toHaveBeenCalledWith('123', dto, 3);
+  });
+
+  it('should reject a patch with unknown fields', async () => {
+    const response = await request(app).patch('/api/{{feature}}/123').send({ notAField: 1 });
+
+    expect(response.status).toBe(400);
+    expect(mockUpdateUseCase.execute).not.toHaveBeenCalled();
+  });
+
+  it('should delete a {{feature}} and pass version conflicts through', async () => {
+    mockDeleteUseCase.execute.mockResolvedValueOnce(Ok(undefined));
+    mockDeleteUseCase.execute.mockResolvedValueOnce(Err(new CustomError(412, 'Modified')));
+
+    expect((await request(app).delete('/api/{{feature}}/123')).status).toBe(204);
+    expect((await request(app).delete('/api/{{feature}}/123').set('If-Match', '1')).status).toBe(412);
+    expect(mockDeleteUseCase.execute).toHaveBeenLastCalledWith('123', 1);
+  });
+});
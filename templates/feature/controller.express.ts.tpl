@@ -0,0 +1,156 @@
+import { injectable, inject } from 'tsyringe';
+import { Request, Response, NextFunction } from 'express';
+import { Router } from 'express';
+import { Create{{Feature}}UseCase, Create{{Feature}}Dto } from '../../domain/usecases/create-{{feature}}.usecase';
+import { CreateMany{{Feature}}UseCase } from '../../domain/usecases/create-many-{{feature}}.usecase';
+import { List{{Feature}}UseCase } from '../../domain/usecases/list-{{feature}}.usecase';
+import { Update{{Feature}}UseCase, Update{{Feature}}Dto } from '../../domain/usecases/update-{{feature}}.usecase';
+import { Delete{{Feature}}UseCase } from '../../domain/usecases/delete-{{feature}}.usecase';
+import { CustomError } from '../../../../Core/error/custom-error';
+import { validate{{Feature}}, validate{{Feature}}Bulk, validate{{Feature}}Patch } from '../middlewares/validate-{{feature}}.middleware';
+import { validate{{Feature}}Record } from '../middlewares/{{feature}}.validator';
+import { serialize{{Feature}}, serialize{{Feature}}Page, serialize{{Feature}}BulkResults } from '../serializers/{{feature}}.serializer';
+import { jsonBody, ndjsonLines } from '../../../../Core/http/body';
+import { ifMatchVersion } from '../../../../Core/http/version';{{metrics_import handlerDuration}}{{tracing_import}}{{protect_import}}
+
+// Import responses list at most this many rejected records
+const MAX_REPORTED_ERRORS = 100;
+
+@injectable()
+export class {{Feature}}Controller {
+  private router: Router;
+
+  constructor(
+    @inject('Create{{Feature}}UseCase') private create{{Feature}}UseCase: Create{{Feature}}UseCase,
+    @inject('CreateMany{{Feature}}UseCase') private createMany{{Feature}}UseCase: CreateMany{{Feature}}UseCase,
+    @inject('List{{Feature}}UseCase') private list{{Feature}}UseCase: List{{Feature}}UseCase,
+    @inject('Update{{Feature}}UseCase') private update{{Feature}}UseCase: Update{{Feature}}UseCase,
+    @inject('Delete{{Feature}}UseCase') private delete{{Feature}}UseCase: Delete{{Feature}}UseCase
+  ) {
+    this.router = Router();{{shed_load}}
+    this.router.get('/', {{rate_limited {feature}.list}}this.list{{Feature}}.bind(this));
+    this.router.post('/', {{rate_limited {feature}.create}}jsonBody('JSON_BODY_LIMIT', '100kb'), validate{{Feature}}, this.create{{Feature}}.bind(this));
+    this.router.post('/bulk', {{rate_limited {feature}.bulk}}jsonBody('BULK_BODY_LIMIT', '10mb'), validate{{Feature}}Bulk, this.createMany{{Feature}}.bind(this));
+    this.router.post('/import', {{rate_limited {feature}.import}}this.import{{Feature}}.bind(this));
+    this.router.patch('/:id', {{rate_limited {feature}.update}}jsonBody('JSON_BODY_LIMIT', '100kb'), validate{{Feature}}Patch, this.update{{Feature}}.bind(this));
+    this.router.delete('/:id', {{rate_limited {feature}.delete}}this.delete{{Feature}}.bind(this));
+  }
+
+  {{timed handlerDuration {Feature}Controller.create{Feature}}}{{traced {Feature}Controller.create{Feature}}}async create{{Feature}}(req: Request, res: Response): Promise<void> {
+    const dto: Create{{Feature}}Dto = req.body;
+    const result = await this.create{{Feature}}UseCase.execute(dto);
+    if (result.isOk()) {
+      res.status(201).type('json').send(serialize{{Feature}}(result.unwrap()));
+    } else {
+      const error = result.unwrapErr();
+      res.status(error.statusCode).json({ message: error.message });
+    }
+  }
+
+  {{timed handlerDuration {Feature}Controller.createMany{Feature}}}{{traced {Feature}Controller.createMany{Feature}}}async createMany{{Feature}}(req: Request, res: Response): Promise<void> {
+    const dtos: Create{{Feature}}Dto[] = req.body;
+    const result = await this.createMany{{Feature}}UseCase.execute(dtos);
+    if (result.isErr()) {
+      const error = result.unwrapErr();
+      res.status(error.statusCode).json({ message: error.message });
+      return;
+    }
+    const results = result.unwrap();
+    const failed = results.filter((item) => item.isErr()).length;
+    res.status(failed === 0 ? 201 : 207).type('json').send(serialize{{Feature}}BulkResults(results, failed));
+  }
+
+  // Streams an NDJSON body (one {{feature}} per line) into MongoDB in BULK_BATCH_SIZE batches; reading pauses while a batch is written
+  {{timed handlerDuration {Feature}Controller.import{Feature}}}{{traced {Feature}Controller.import{Feature}}}async import{{Feature}}(req: Request, res: Response, next: NextFunction): Promise<void> {
+    const batchSize = Number(process.env.BULK_BATCH_SIZE) || 500;
+    const summary = { received: 0, inserted: 0, failed: 0, errors: [] as { record: number; message: string }[] };
+    const reject = (record: number, message: string) => {
+      summary.failed++;
+      if (summary.errors.length < MAX_REPORTED_ERRORS) summary.errors.push({ record, message });
+    };
+    let batch: Create{{Feature}}Dto[] = [];
+    let batchRecords: number[] = [];
+    const flush = async () => {
+      const result = await this.createMany{{Feature}}UseCase.execute(batch);
+      if (result.isErr()) throw result.unwrapErr();
+      result.unwrap().forEach((item, index) => {
+        if (item.isOk()) summary.inserted++;
+        else reject(batchRecords[index], item.unwrapErr().message);
+      });
+      batch = [];
+      batchRecords = [];
+    };
+    try {
+      for await (const line of ndjsonLines(req)) {
+        const record = ++summary.received;
+        let body: unknown;
+        try {
+          body = JSON.parse(line);
+        } catch {
+          reject(record, 'invalid JSON');
+          continue;
+        }
+        const message = validate{{Feature}}Record(body);
+        if (message !== null) {
+          reject(record, message);
+          continue;
+        }
+        batch.push(body as Create{{Feature}}Dto);
+        batchRecords.push(record);
+        if (batch.length === batchSize) await flush();
+      }
+      if (batch.length > 0) await flush();
+      res.status(summary.failed === 0 ? 201 : 207).json(summary);
+    } catch (error) {
+      next(error);
+    }
+  }
+
+  {{timed handlerDuration {Feature}Controller.list{Feature}}}{{traced {Feature}Controller.list{Feature}}}async list{{Feature}}(req: Request, res: Response): Promise<void> {
+    const cursor = typeof req.query.cursor === 'string' ? req.query.cursor : null;
+    const limit = req.query.limit ? Number(req.query.limit) : undefined;
+    const result = await this.list{{Feature}}UseCase.execute(cursor, limit);
+    if (result.isOk()) {
+      res.status(200).type('json').send(serialize{{Feature}}Page(result.unwrap()));
+    } else {
+      const error = result.unwrapErr();
+      res.status(error.statusCode).json({ message: error.message });
+    }
+  }
+
+  // PATCH /:id writes only the fields in the body; with If-Match: <version> it applies only to that version (412 if stale)
+  {{timed handlerDuration {Feature}Controller.update{Feature}}}{{traced {Feature}Controller.update{Feature}}}async update{{Feature}}(req: Request, res: Response): Promise<void> {
+    const expectedVersion = ifMatchVersion(req.headers['if-match']);
+    if (Number.isNaN(expectedVersion)) {
+      res.status(400).json({ message: 'If-Match must be a version number' });
+      return;
+    }
+    const dto: Update{{Feature}}Dto = req.body;
+    const result = await this.update{{Feature}}UseCase.execute(req.params.id, dto, expectedVersion);
+    if (result.isOk()) {
+      res.status(200).type('json').send(serialize{{Feature}}(result.unwrap()));
+    } else {
+      const error = result.unwrapErr();
+      res.status(error.statusCode).json({ message: error.message });
+    }
+  }
+
+  {{timed handlerDuration {Feature}Controller.delete{Feature}}}{{traced {Feature}Controller.delete{Feature}}}async delete{{Feature}}(req: Request, res: Response): Promise<void> {
+    const expectedVersion = ifMatchVersion(req.headers['if-match']);
+    if (Number.isNaN(expectedVersion)) {
+      res.status(400).json({ message: 'If-Match must be a version number' });
+      return;
+    }
+    const result = await this.delete{{Feature}}UseCase.execute(req.params.id, expectedVersion);
+    if (result.isOk()) {
+      res.status(204).end();
+    } else {
+      const error = result.unwrapErr();
+      res.status(error.statusCode).json({ message: error.message });
+    }
+  }
+
+  getRouter(): Router {
+    return this.router;
+  }
+}
@@ -0,0 +1,130 @@
+import Fastify, { FastifyInstance } from 'fastify';
+import { container } from '../../../Features/{{feature}}/container';
+import { {{Feature}}Controller } from '../../../Features/{{feature}}/delivery/controllers/{{feature}}.controller';
+import { Create{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/create-{{feature}}.usecase';
+import { CreateMany{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/create-many-{{feature}}.usecase';
+import { List{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/list-{{feature}}.usecase';
+import { Update{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/update-{{feature}}.usecase';
+import { Delete{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/delete-{{feature}}.usecase';
+import { Ok, Err } from '../../../Core/result/result';
+import { CustomError } from '../../../Core/error/custom-error';
+import { errorHandler } from '../../../Core/error/error-handler';
+import { {{Feature}} } from '../../../Features/{{feature}}/domain/entity/{{feature}}.entity';
+
+describe('{{Feature}}Controller', () => {
+  let app: FastifyInstance;
+  let mockUseCase: jest.Mocked<Create{{Feature}}UseCase>;
+  let mockCreateManyUseCase: jest.Mocked<CreateMany{{Feature}}UseCase>;
+  let mockListUseCase: jest.Mocked<List{{Feature}}UseCase>;
+  let mockUpdateUseCase: jest.Mocked<Update{{Feature}}UseCase>;
+  let mockDeleteUseCase: jest.Mocked<Delete{{Feature}}UseCase>;
+  const dto = {{sample}};
+  const {{feature}} = new {{Feature}}('123', {{dto_args}});
+
+  beforeEach(async () => {
+    mockUseCase = { execute: jest.fn() } as unknown as jest.Mocked<Create{{Feature}}UseCase>;
+    mockCreateManyUseCase = { execute: jest.fn() } as unknown as jest.Mocked<CreateMany{{Feature}}UseCase>;
+    mockListUseCase = { execute: jest.fn() } as unknown as jest.Mocked<List{{Feature}}UseCase>;
+    mockUpdateUseCase = { execute: jest.fn() } as unknown as jest.Mocked<Update{{Feature}}UseCase>;
+    mockDeleteUseCase = { execute: jest.fn() } as unknown as jest.Mocked<Delete{{Feature}}UseCase>;
+    container.registerInstance('Create{{Feature}}UseCase', mockUseCase);
+    container.registerInstance('CreateMany{{Feature}}UseCase', mockCreateManyUseCase);
+    container.registerInstance('List{{Feature}}UseCase', mockListUseCase);
+    container.registerInstance('Update{{Feature}}UseCase', mockUpdateUseCase);
+    container.registerInstance('Delete{{Feature}}UseCase', mockDeleteUseCase);
+    app = Fastify();
+    app.setErrorHandler(errorHandler);
+    app.register(container.resolve({{Feature}}Controller).routes, { prefix: '/api/{{feature}}' });
+    await app.ready();
+  });
+
+  afterEach(async () => {
+    await app.close();
+    // Drops the mock and any cached instances but keeps the registrations from container.ts
+    container.clearInstances();
+  });
+
+  it('should create a {{feature}} and return 201', async () => {
+    mockUseCase.execute.mockResolvedValue(Ok({{feature}}));
+
+    const response = await app.inject({ method: 'POST', url: '/api/{{feature}}', payload: dto });
+
+    expect(response.statusCode).toBe(201);
+    expect(response.json()).toEqual({
+      id: '123',
+      {{dto_props}}version: 0,
+    });
+    expect(mockUseCase.execute).toHaveBeenCalledWith(dto);
+  });
+
+  it('should return 400 for invalid input', async () => {
+    const response = await app.inject({ method: 'POST', url: '/api/{{feature}}', payload: {} });
+
+    expect(response.statusCode).toBe(400);
+    expect(response.json().message).toContain('required property');
+  });
+
+  it('should report per-item results for a bulk create', async () => {
+    mockCreateManyUseCase.execute.mockResolvedValue(Ok([Ok({{feature}}), Err(new CustomError(409, 'Duplicate'))]));
+
+    const response = await app.inject({ method: 'POST', url: '/api/{{feature}}/bulk', payload: [dto, dto] });
+
+    expect(response.statusCode).toBe(207);
+    expect(response.json().inserted).toBe(1);
+    expect(response.json().failed).toBe(1);
+    expect(response.json().results[1]).toEqual({ kind: 'Err', error: { statusCode: 409, message: 'Duplicate' } });
+    expect(mockCreateManyUseCase.execute).toHaveBeenCalledWith([dto, dto]);
+  });
+
+  it('should import NDJSON records in batches and report rejected lines', async () => {
+    mockCreateManyUseCase.execute.mockResolvedValue(Ok([Ok({{feature}}), Ok({{feature}})]));
+
+    const response = await app.inject({
+      method: 'POST',
+      url: '/api/{{feature}}/import',
+      headers: { 'content-type': 'application/x-ndjson' },
+      payload: [JSON.stringify(dto), '{}', 'not json', JSON.stringify(dto)].join('\n'),
+    });
+
+    expect(response.statusCode).toBe(207);
+    expect(response.json()).toMatchObject({ received: 4, inserted: 2, failed: 2 });
+    expect(response.json().errors[1]).toEqual({ record: 3, message: 'invalid JSON' });
+    expect(mockCreateManyUseCase.execute).toHaveBeenCalledWith([dto, dto]);
+  });
+
+  it('should return a page and pass the cursor through', async () => {
+    mockListUseCase.execute.mockResolvedValue(Ok({ items: [{{feature}}], nextCursor: 'next' }));
+
+    const response = await app.inject({ method: 'GET', url: '/api/{{feature}}?cursor=abc&limit=5' });
+
+    expect(response.statusCode).toBe(200);
+    expect(response.json().nextCursor).toBe('next');
+    expect(mockListUseCase.execute).toHaveBeenCalledWith('abc', 5);
+  });
+
+  it('should update a {{feature}} with the If-Match version and return 200', async () => {
+    mockUpdateUseCase.execute.mockResolvedValue(Ok(new {{Feature}}('123', {{dto_args}}, 4)));
+
+    const response = await app.inject({ method: 'PATCH', url: '/api/{{feature}}/123', headers: { 'if-match': '"3"' }, payload: dto });
+
+    expect(response.statusCode).toBe(200);
+    expect(response.json().version).toBe(4);
+    expect(mockUpdateUseCase.execute).toHaveBeenCalledWith('123', dto, 3);
+  });
+
+  it('should reject a patch with unknown fields', async () => {
+    const response = await app.inject({ method: 'PATCH', url: '/api/{{feature}}/123', payload: { notAField: 1 } });
+
+    expect(response.statusCode).toBe(400);
+    expect(mockUpdateUseCase.execute).not.toHaveBeenCalled();
+  });
+
+  it('should delete a {{feature}} and pass version conflicts through', async () => {
+    mockDeleteUseCase.execute.mockResolvedValueOnce(Ok(undefined));
+    mockDeleteUseCase.execute.mockResolvedValueOnce(Err(new CustomError(412, 'Modified')));
+
+    expect((await app.inject({ method: 'DELETE', url: '/api/{{feature}}/123' })).statusCode).toBe(204);
+    expect((await app.inject({ method: 'DELETE', url: '/api/{{feature}}/123', headers: { 'if-match': '1' } })).statusCode).toBe(412);
+    expect(mockDeleteUseCase.execute).toHaveBeenLastCalledWith('123', 1);
+  });
+});
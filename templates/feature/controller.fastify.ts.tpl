@@ -0,0 +1,153 @@
+import { injectable, inject } from 'tsyringe';
+import { FastifyInstance, FastifyRequest, FastifyReply } from 'fastify';
+import { Readable } from 'node:stream';
+import { Create{{Feature}}UseCase, Create{{Feature}}Dto } from '../../domain/usecases/create-{{feature}}.usecase';
+import { CreateMany{{Feature}}UseCase } from '../../domain/usecases/create-many-{{feature}}.usecase';
+import { List{{Feature}}UseCase } from '../../domain/usecases/list-{{feature}}.usecase';
+import { Update{{Feature}}UseCase, Update{{Feature}}Dto } from '../../domain/usecases/update-{{feature}}.usecase';
+import { Delete{{Feature}}UseCase } from '../../domain/usecases/delete-{{feature}}.usecase';
+import { validate{{Feature}}Record } from '../middlewares/{{feature}}.validator';
+import { {{feature}}RouteSchemas } from '../schemas/{{feature}}.schema';
+import { bodyLimit, ndjsonLines } from '../../../../Core/http/body';
+import { ifMatchVersion } from '../../../../Core/http/version';{{metrics_import handlerDuration}}{{tracing_import}}{{protect_import}}
+
+// Import responses list at most this many rejected records
+const MAX_REPORTED_ERRORS = 100;
+
+@injectable()
+export class {{Feature}}Controller {
+  constructor(
+    @inject('Create{{Feature}}UseCase') private create{{Feature}}UseCase: Create{{Feature}}UseCase,
+    @inject('CreateMany{{Feature}}UseCase') private createMany{{Feature}}UseCase: CreateMany{{Feature}}UseCase,
+    @inject('List{{Feature}}UseCase') private list{{Feature}}UseCase: List{{Feature}}UseCase,
+    @inject('Update{{Feature}}UseCase') private update{{Feature}}UseCase: Update{{Feature}}UseCase,
+    @inject('Delete{{Feature}}UseCase') private delete{{Feature}}UseCase: Delete{{Feature}}UseCase
+  ) {}
+
+  // Fastify plugin, registered by Server/index.ts under /api/{{feature}}
+  routes = async (app: FastifyInstance): Promise<void> => {
+    // NDJSON bodies reach the import route as the raw request stream instead of being buffered
+    app.addContentTypeParser('application/x-ndjson', (request, payload, done) => done(null, payload));{{shed_load}}
+    app.get('/', { {{rate_limited {feature}.list}}schema: {{feature}}RouteSchemas.list }, this.list{{Feature}}.bind(this));
+    app.post('/', { {{rate_limited {feature}.create}}schema: {{feature}}RouteSchemas.create, bodyLimit: bodyLimit('JSON_BODY_LIMIT', '100kb') }, this.create{{Feature}}.bind(this));
+    app.post('/bulk', { {{rate_limited {feature}.bulk}}schema: {{feature}}RouteSchemas.bulk, bodyLimit: bodyLimit('BULK_BODY_LIMIT', '10mb') }, this.createMany{{Feature}}.bind(this));
+    app.post('/import', { {{rate_limited {feature}.import}}schema: {{feature}}RouteSchemas.import }, this.import{{Feature}}.bind(this));
+    app.patch('/:id', { {{rate_limited {feature}.update}}schema: {{feature}}RouteSchemas.update, bodyLimit: bodyLimit('JSON_BODY_LIMIT', '100kb') }, this.update{{Feature}}.bind(this));
+    app.delete('/:id', { {{rate_limited {feature}.delete}}schema: {{feature}}RouteSchemas.delete }, this.delete{{Feature}}.bind(this));
+  };
+
+  {{timed handlerDuration {Feature}Controller.create{Feature}}}{{traced {Feature}Controller.create{Feature}}}async create{{Feature}}(request: FastifyRequest<{ Body: Create{{Feature}}Dto }>, reply: FastifyReply): Promise<void> {
+    const result = await this.create{{Feature}}UseCase.execute(request.body);
+    if (result.isOk()) {
+      reply.code(201).send(result.unwrap());
+    } else {
+      const error = result.unwrapErr();
+      reply.code(error.statusCode).send({ message: error.message });
+    }
+  }
+
+  {{timed handlerDuration {Feature}Controller.createMany{Feature}}}{{traced {Feature}Controller.createMany{Feature}}}async createMany{{Feature}}(request: FastifyRequest<{ Body: Create{{Feature}}Dto[] }>, reply: FastifyReply): Promise<void> {
+    const maxItems = Number(process.env.BULK_MAX_ITEMS) || 10000;
+    if (request.body.length > maxItems) {
+      reply.code(413).send({ message: 'Bulk requests are limited to ' + maxItems + ' items' });
+      return;
+    }
+    const result = await this.createMany{{Feature}}UseCase.execute(request.body);
+    if (result.isErr()) {
+      const error = result.unwrapErr();
+      reply.code(error.statusCode).send({ message: error.message });
+      return;
+    }
+    let failed = 0;
+    const results = result.unwrap().map((item) => {
+      if (item.isOk()) return { kind: 'Ok', value: item.unwrap() };
+      failed++;
+      const error = item.unwrapErr();
+      return { kind: 'Err', error: { statusCode: error.statusCode, message: error.message } };
+    });
+    reply.code(failed === 0 ? 201 : 207).send({ inserted: results.length - failed, failed, results });
+  }
+
+  // Streams an NDJSON body (one {{feature}} per line) into MongoDB in BULK_BATCH_SIZE batches; reading pauses while a batch is written
+  {{timed handlerDuration {Feature}Controller.import{Feature}}}{{traced {Feature}Controller.import{Feature}}}async import{{Feature}}(request: FastifyRequest, reply: FastifyReply): Promise<void> {
+    const batchSize = Number(process.env.BULK_BATCH_SIZE) || 500;
+    const summary = { received: 0, inserted: 0, failed: 0, errors: [] as { record: number; message: string }[] };
+    const reject = (record: number, message: string) => {
+      summary.failed++;
+      if (summary.errors.length < MAX_REPORTED_ERRORS) summary.errors.push({ record, message });
+    };
+    let batch: Create{{Feature}}Dto[] = [];
+    let batchRecords: number[] = [];
+    const flush = async () => {
+      const result = await this.createMany{{Feature}}UseCase.execute(batch);
+      if (result.isErr()) throw result.unwrapErr();
+      result.unwrap().forEach((item, index) => {
+        if (item.isOk()) summary.inserted++;
+        else reject(batchRecords[index], item.unwrapErr().message);
+      });
+      batch = [];
+      batchRecords = [];
+    };
+    for await (const line of ndjsonLines(request.body as Readable)) {
+      const record = ++summary.received;
+      let body: unknown;
+      try {
+        body = JSON.parse(line);
+      } catch {
+        reject(record, 'invalid JSON');
+        continue;
+      }
+      const message = validate{{Feature}}Record(body);
+      if (message !== null) {
+        reject(record, message);
+        continue;
+      }
+      batch.push(body as Create{{Feature}}Dto);
+      batchRecords.push(record);
+      if (batch.length === batchSize) await flush();
+    }
+    if (batch.length > 0) await flush();
+    reply.code(summary.failed === 0 ? 201 : 207).send(summary);
+  }
+
+  {{timed handlerDuration {Feature}Controller.list{Feature}}}{{traced {Feature}Controller.list{Feature}}}async list{{Feature}}(request: FastifyRequest<{ Querystring: { cursor?: string; limit?: number } }>, reply: FastifyReply): Promise<void> {
+    const result = await this.list{{Feature}}UseCase.execute(request.query.cursor ?? null, request.query.limit);
+    if (result.isOk()) {
+      reply.code(200).send(result.unwrap());
+    } else {
+      const error = result.unwrapErr();
+      reply.code(error.statusCode).send({ message: error.message });
+    }
+  }
+
+  // PATCH /:id writes only the fields in the body; with If-Match: <version> it applies only to that version (412 if stale)
+  {{timed handlerDuration {Feature}Controller.update{Feature}}}{{traced {Feature}Controller.update{Feature}}}async update{{Feature}}(request: FastifyRequest<{ Params: { id: string }; Body: Update{{Feature}}Dto }>, reply: FastifyReply): Promise<void> {
+    const expectedVersion = ifMatchVersion(request.headers['if-match']);
+    if (Number.isNaN(expectedVersion)) {
+      reply.code(400).send({ message: 'If-Match must be a version number' });
+      return;
+    }
+    const result = await this.update{{Feature}}UseCase.execute(request.params.id, request.body, expectedVersion);
+    if (result.isOk()) {
+      reply.code(200).send(result.unwrap());
+    } else {
+      const error = result.unwrapErr();
+      reply.code(error.statusCode).send({ message: error.message });
+    }
+  }
+
+  {{timed handlerDuration {Feature}Controller.delete{Feature}}}{{traced {Feature}Controller.delete{Feature}}}async delete{{Feature}}(request: FastifyRequest<{ Params: { id: string } }>, reply: FastifyReply): Promise<void> {
+    const expectedVersion = ifMatchVersion(request.headers['if-match']);
+    if (Number.isNaN(expectedVersion)) {
+      reply.code(400).send({ message: 'If-Match must be a version number' });
+      return;
+    }
+    const result = await this.delete{{Feature}}UseCase.execute(request.params.id, expectedVersion);
+    if (result.isOk()) {
+      reply.code(204).send();
+    } else {
+      const error = result.unwrapErr();
+      reply.code(error.statusCode).send({ message: error.message });
+    }
+  }
+}
@@ -0,0 +1,21 @@
+import { injectable, inject } from 'tsyringe';
+import { {{Feature}} } from '../entity/{{feature}}.entity';
+import { {{Feature}}Repository } from '../repositories/{{feature}}.repository.interface';
+import { Create{{Feature}}Dto } from './create-{{feature}}.usecase';
+import { Result{{create_many_err_import}} } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';
+import { newId } from '../../../../Core/id/id';{{create_many_offload_import}}{{metrics_import useCaseDuration}}{{tracing_import}}
+
+@injectable()
+export class CreateMany{{Feature}}UseCase {
+  constructor(@inject('{{Feature}}Repository') private {{feature}}Repository: {{Feature}}Repository) {}
+
+  // Returns one Result per input item, in input order; the outer Err is reserved for failures of the whole request
+  {{timed useCaseDuration CreateMany{Feature}UseCase}}{{traced CreateMany{Feature}UseCase.execute}}async execute(dtos: Create{{Feature}}Dto[]): Promise<Result<Result<{{Feature}}, CustomError>[], CustomError>> {{{create_many_offload}}
+    const {{feature}}List = dtos.map((dto) => new {{Feature}}(
+      newId(),
+      {{dto_args}}
+    ));
+    return await this.{{feature}}Repository.createMany({{feature}}List);
+  }
+}
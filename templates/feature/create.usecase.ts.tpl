@@ -0,0 +1,23 @@
+import { injectable, inject } from 'tsyringe';
+import { {{Feature}} } from '../entity/{{feature}}.entity';
+import { {{Feature}}Repository } from '../repositories/{{feature}}.repository.interface';
+import { Result, Ok, Err } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';
+import { newId } from '../../../../Core/id/id';{{create_offload_import}}{{metrics_import useCaseDuration}}{{tracing_import}}
+
+export interface Create{{Feature}}Dto {
+  {{dto_fields}}
+}
+
+@injectable()
+export class Create{{Feature}}UseCase {
+  constructor(@inject('{{Feature}}Repository') private {{feature}}Repository: {{Feature}}Repository) {}
+
+  {{timed useCaseDuration Create{Feature}UseCase}}{{traced Create{Feature}UseCase.execute}}async execute(dto: Create{{Feature}}Dto): Promise<Result<{{Feature}}, CustomError>> {{{create_offload}}
+    const {{feature}} = new {{Feature}}(
+      newId(),
+      {{dto_args}}
+    );
+    return await this.{{feature}}Repository.create({{feature}});
+  }
+}
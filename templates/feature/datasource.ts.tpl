@@ -0,0 +1,129 @@
+import { injectable } from 'tsyringe';
+import { Types } from 'mongoose';
+import { {{Feature}} } from '../../domain/entity/{{feature}}.entity';
+import { {{Feature}}Page, {{Feature}}Changes } from '../../domain/repositories/{{feature}}.repository.interface';
+import { {{Feature}}Model } from '../models/{{feature}}.model';
+import { Result, Ok, Err } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';{{replica_import}}{{outbox_import}}{{metrics_import dataSourceDuration}}{{tracing_import}}
+
+type WriteError = { index: number; code?: number; errmsg?: string };
+type {{Feature}}Record = {{record_type}};
+type {{Feature}}Row = {{row_type}};
+type PageCursor = { key?: unknown; id: string };
+
+// The entity's columns: what lean reads and findOneAndUpdate send back
+const {{feature}}Projection = { {{projection_fields}} };{{id_declarations}}{{outbox_declarations}}
+
+// Matches the document only at the version the client last saw; documents stored before versioning count as version 0
+const versionFilter = (id: string, expectedVersion?: number) =>
+  expectedVersion === undefined
+    ? { {{doc_id}}: id }
+    : { {{doc_id}}: id, version: expectedVersion === 0 ? { $in: [0, null] } : expectedVersion };
+
+// A conditional write that matched nothing: the id is unknown (Ok(miss)), or it is stored at another version
+const missOrConflict = async <T>(id: string, expectedVersion: number | undefined, miss: T): Promise<Result<T, CustomError>> =>
+  expectedVersion !== undefined && (await {{Feature}}Model.exists({ {{doc_id}}: id }))
+    ? Err(new CustomError(412, '{{feature}} ' + id + ' was modified after version ' + expectedVersion))
+    : Ok(miss);
+
+const encodeCursor = (cursor: PageCursor): string => Buffer.from(JSON.stringify(cursor)).toString('base64url');
+
+const decodeCursor = (cursor: string): PageCursor | null => {
+  try {
+    const decoded = JSON.parse(Buffer.from(cursor, 'base64url').toString());
+    return {{cursor_check}} ? decoded : null;
+  } catch {
+    return null;
+  }
+};
+
+@injectable()
+export class {{Feature}}DataSource {
+  {{timed dataSourceDuration {feature}.create}}{{traced {Feature}DataSource.create}}async create({{feature}}: {{Feature}}): Promise<Result<{{Feature}}, CustomError>> {
+    try {
+{{create_write}}
+      return Ok({{feature}});
+    } catch (error) {
+      return Err(new CustomError(500, 'Failed to create {{feature}}: ' + (error as Error).message));
+    }
+  }
+
+  {{timed dataSourceDuration {feature}.createMany}}{{traced {Feature}DataSource.createMany}}async createMany({{feature}}List: {{Feature}}[]): Promise<Result<Result<{{Feature}}, CustomError>[], CustomError>> {
+    const batchSize = Number(process.env.BULK_BATCH_SIZE) || 500;
+    const results: Result<{{Feature}}, CustomError>[] = [];
+    for (let offset = 0; offset < {{feature}}List.length; offset += batchSize) {
+      const batch = {{feature}}List.slice(offset, offset + batchSize);
+      const failures = new Map<number, CustomError>();
+{{create_many_write}}
+      batch.forEach(({{feature}}, index) => {
+        const failure = failures.get(index);
+        results.push(failure ? Err(failure) : Ok({{feature}}));
+      });
+    }
+    return Ok(results);
+  }
+
+  {{timed dataSourceDuration {feature}.findById}}{{traced {Feature}DataSource.findById}}async findById(id: string): Promise<Result<{{Feature}} | null, CustomError>> {
+    try {{{find_by_id_query}}
+      if (!{{feature}}Doc) return Ok(null);
+      return Ok(new {{Feature}}({{feature}}Doc.{{doc_id}}, {{feature_doc_args}}, {{feature}}Doc.version));
+    } catch (error) {
+      return Err(new CustomError(500, 'Failed to find {{feature}}: ' + (error as Error).message));
+    }
+  }
+
+  {{timed dataSourceDuration {feature}.findPage}}{{traced {Feature}DataSource.findPage}}async findPage(cursor: string | null, limit: number): Promise<Result<{{Feature}}Page, CustomError>> {
+    const after = cursor ? decodeCursor(cursor) : null;
+    if (cursor && !after) return Err(new CustomError(400, 'Invalid cursor'));
+    try {
+      // Seek past the cursor instead of skipping, and read one extra row to learn whether another page exists
+      const rows = {{Feature}}Model.find({{page_filter}})
+        .sort({{page_sort}})
+        .limit(limit + 1){{page_read}}
+        .lean<{{Feature}}Row[]>()
+        .cursor();
+      const items: {{Feature}}[] = [];
+      let last: {{Feature}}Row | null = null;
+      let hasMore = false;
+      for await (const doc of rows) {
+        if (items.length === limit) {
+          hasMore = true;
+          break;
+        }
+        items.push(new {{Feature}}(doc.{{doc_id}}, {{doc_args}}, doc.version));
+        last = doc;
+      }
+      const nextCursor = hasMore && last ? encodeCursor({{page_next}}) : null;
+      return Ok({ items, nextCursor });
+    } catch (error) {
+      return Err(new CustomError(500, 'Failed to list {{feature}}: ' + (error as Error).message));
+    }
+  }
+
+  {{timed dataSourceDuration {feature}.update}}{{traced {Feature}DataSource.update}}async update(id: string, changes: {{Feature}}Changes, expectedVersion?: number): Promise<Result<{{Feature}} | null, CustomError>> {
+    // Only the fields the request carries are written, instead of loading the document and saving all of it back
+    const $set = Object.fromEntries(Object.entries(changes).filter(([, value]) => value !== undefined));
+    try {
+      // One round trip: the version check, the write and the read-back happen in a single atomic findOneAndUpdate
+      const {{feature}}Doc = await {{Feature}}Model.findOneAndUpdate(
+        versionFilter(id, expectedVersion),
+        { $set, $inc: { version: 1 } },
+        { returnDocument: 'after', projection: {{feature}}Projection, runValidators: true },
+      ).lean<{{Feature}}Record>();
+      if (!{{feature}}Doc) return await missOrConflict(id, expectedVersion, null);
+      return Ok(new {{Feature}}({{feature}}Doc.{{doc_id}}, {{feature_doc_args}}, {{feature}}Doc.version));
+    } catch (error) {
+      return Err(new CustomError(500, 'Failed to update {{feature}}: ' + (error as Error).message));
+    }
+  }
+
+  {{timed dataSourceDuration {feature}.delete}}{{traced {Feature}DataSource.delete}}async delete(id: string, expectedVersion?: number): Promise<Result<boolean, CustomError>> {
+    try {
+      const { deletedCount } = await {{Feature}}Model.deleteOne(versionFilter(id, expectedVersion));
+      if (deletedCount === 0) return await missOrConflict(id, expectedVersion, false);
+      return Ok(true);
+    } catch (error) {
+      return Err(new CustomError(500, 'Failed to delete {{feature}}: ' + (error as Error).message));
+    }
+  }
+}
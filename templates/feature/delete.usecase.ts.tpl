@@ -0,0 +1,15 @@
+import { injectable, inject } from 'tsyringe';
+import { {{Feature}}Repository } from '../repositories/{{feature}}.repository.interface';
+import { Result, Ok, Err } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';{{metrics_import useCaseDuration}}{{tracing_import}}
+
+@injectable()
+export class Delete{{Feature}}UseCase {
+  constructor(@inject('{{Feature}}Repository') private {{feature}}Repository: {{Feature}}Repository) {}
+
+  {{timed useCaseDuration Delete{Feature}UseCase}}{{traced Delete{Feature}UseCase.execute}}async execute(id: string, expectedVersion?: number): Promise<Result<void, CustomError>> {
+    const result = await this.{{feature}}Repository.delete(id, expectedVersion);
+    if (result.isErr()) return Err(result.unwrapErr());
+    return result.unwrap() ? Ok(undefined) : Err(new CustomError(404, '{{feature}} ' + id + ' not found'));
+  }
+}
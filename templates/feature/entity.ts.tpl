@@ -0,0 +1,8 @@
+export class {{Feature}} {
+  constructor(
+    public id: string,
+    {{entity_params}},
+    // Bumped by every update; clients send it back in If-Match so a stale write is rejected
+    public version: number = 0
+  ) {}
+}
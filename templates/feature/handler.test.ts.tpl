@@ -0,0 +1,129 @@
+import { container } from '../../../Features/{{feature}}/container';
+import { {{Feature}}Handler } from '../../../Features/{{feature}}/delivery/handlers/{{feature}}.handler';
+import { Create{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/create-{{feature}}.usecase';
+import { CreateMany{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/create-many-{{feature}}.usecase';
+import { List{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/list-{{feature}}.usecase';
+import { Update{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/update-{{feature}}.usecase';
+import { Delete{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/delete-{{feature}}.usecase';
+import { Ok, Err } from '../../../Core/result/result';
+import { CustomError } from '../../../Core/error/custom-error';
+import { dispatch, FeatureHandler, HttpRequest } from '../../../Core/serverless/http';
+import { {{Feature}} } from '../../../Features/{{feature}}/domain/entity/{{feature}}.entity';
+
+const httpRequest = (method: string, path: string, body?: unknown, headers: Record<string, string> = {}): HttpRequest => {
+  const [pathname, search] = path.split('?');
+  return {
+    method,
+    path: pathname,
+    query: Object.fromEntries(new URLSearchParams(search).entries()),
+    headers,
+    body: body === undefined ? '' : JSON.stringify(body),
+  };
+};
+
+describe('{{Feature}}Handler', () => {
+  let handlers: Map<string, FeatureHandler>;
+  let mockUseCase: jest.Mocked<Create{{Feature}}UseCase>;
+  let mockCreateManyUseCase: jest.Mocked<CreateMany{{Feature}}UseCase>;
+  let mockListUseCase: jest.Mocked<List{{Feature}}UseCase>;
+  let mockUpdateUseCase: jest.Mocked<Update{{Feature}}UseCase>;
+  let mockDeleteUseCase: jest.Mocked<Delete{{Feature}}UseCase>;
+
+  beforeEach(() => {
+    mockUseCase = {
+      execute: jest.fn(),
+    };
+    mockCreateManyUseCase = {
+      execute: jest.fn(),
+    };
+    mockListUseCase = {
+      execute: jest.fn(),
+    };
+    mockUpdateUseCase = {
+      execute: jest.fn(),
+    };
+    mockDeleteUseCase = {
+      execute: jest.fn(),
+    };
+    container.registerInstance('Create{{Feature}}UseCase', mockUseCase);
+    container.registerInstance('CreateMany{{Feature}}UseCase', mockCreateManyUseCase);
+    container.registerInstance('List{{Feature}}UseCase', mockListUseCase);
+    container.registerInstance('Update{{Feature}}UseCase', mockUpdateUseCase);
+    container.registerInstance('Delete{{Feature}}UseCase', mockDeleteUseCase);
+    handlers = new Map([['{{feature}}', container.resolve({{Feature}}Handler)]]);
+  });
+
+  afterEach(() => {
+    // Drops the mock and any cached instances but keeps the registrations from container.ts
+    container.clearInstances();
+  });
+
+  it('should create a {{feature}} and return 201', async () => {
+    const dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}});
+    mockUseCase.execute.mockResolvedValue(Ok({{feature}}));
+
+    const response = await dispatch(handlers, httpRequest('POST', '/api/{{feature}}', dto));
+
+    expect(response.statusCode).toBe(201);
+    expect(JSON.parse(response.body)).toEqual({
+      id: '123',
+      {{dto_props}}version: 0,
+    });
+    expect(mockUseCase.execute).toHaveBeenCalledWith(dto);
+  });
+
+  it('should return 400 for invalid input or malformed JSON', async () => {
+    const invalid = await dispatch(handlers, httpRequest('POST', '/api/{{feature}}', {}));
+    const malformed = await dispatch(handlers, { ...httpRequest('POST', '/api/{{feature}}'), body: '{' });
+
+    expect(invalid.statusCode).toBe(400);
+    expect(JSON.parse(invalid.body).message).toContain('is required');
+    expect(malformed.statusCode).toBe(400);
+    expect(mockUseCase.execute).not.toHaveBeenCalled();
+  });
+
+  it('should report per-item results for a bulk create', async () => {
+    const dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}});
+    mockCreateManyUseCase.execute.mockResolvedValue(Ok([Ok({{feature}}), Err(new CustomError(409, 'Duplicate'))]));
+
+    const response = await dispatch(handlers, httpRequest('POST', '/api/{{feature}}/bulk', [dto, dto]));
+
+    expect(response.statusCode).toBe(207);
+    expect(JSON.parse(response.body).failed).toBe(1);
+    expect(mockCreateManyUseCase.execute).toHaveBeenCalledWith([dto, dto]);
+  });
+
+  it('should return a page and pass the cursor through', async () => {
+    const dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}});
+    mockListUseCase.execute.mockResolvedValue(Ok({ items: [{{feature}}], nextCursor: 'next' }));
+
+    const response = await dispatch(handlers, httpRequest('GET', '/api/{{feature}}?cursor=abc&limit=5'));
+
+    expect(response.statusCode).toBe(200);
+    expect(JSON.parse(response.body).nextCursor).toBe('next');
+    expect(mockListUseCase.execute).toHaveBeenCalledWith('abc', 5);
+  });
+
+  it('should update with the If-Match version and delete by id', async () => {
+    const dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}}, 4);
+    mockUpdateUseCase.execute.mockResolvedValue(Ok({{feature}}));
+    mockDeleteUseCase.execute.mockResolvedValue(Err(new CustomError(412, 'Modified')));
+
+    const updated = await dispatch(handlers, httpRequest('PATCH', '/api/{{feature}}/123', dto, { 'if-match': '"3"' }));
+    const deleted = await dispatch(handlers, httpRequest('DELETE', '/api/{{feature}}/123', undefined, { 'if-match': '1' }));
+
+    expect(updated.statusCode).toBe(200);
+    expect(mockUpdateUseCase.execute).toHaveBeenCalledWith('123', dto, 3);
+    expect(deleted.statusCode).toBe(412);
+    expect(mockDeleteUseCase.execute).toHaveBeenCalledWith('123', 1);
+  });
+
+  it('should answer 404 for routes it does not serve', async () => {
+    expect((await dispatch(handlers, httpRequest('POST', '/api/{{feature}}/import'))).statusCode).toBe(404);
+    expect((await dispatch(handlers, httpRequest('GET', '/api/unknown'))).statusCode).toBe(404);
+  });
+});
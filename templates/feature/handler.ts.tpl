@@ -0,0 +1,96 @@
+import { injectable, inject } from 'tsyringe';
+import { Create{{Feature}}UseCase, Create{{Feature}}Dto } from '../../domain/usecases/create-{{feature}}.usecase';
+import { CreateMany{{Feature}}UseCase } from '../../domain/usecases/create-many-{{feature}}.usecase';
+import { List{{Feature}}UseCase } from '../../domain/usecases/list-{{feature}}.usecase';
+import { Update{{Feature}}UseCase, Update{{Feature}}Dto } from '../../domain/usecases/update-{{feature}}.usecase';
+import { Delete{{Feature}}UseCase } from '../../domain/usecases/delete-{{feature}}.usecase';
+import { CustomError } from '../../../../Core/error/custom-error';
+import { ifMatchVersion } from '../../../../Core/http/version';
+import { FeatureHandler, HttpRequest, HttpResponse, jsonResponse, emptyResponse, errorResponse, parseJson } from '../../../../Core/serverless/http';
+import { {{handler_validator_import}} } from '../middlewares/{{feature}}.validator';
+import { serialize{{Feature}}, serialize{{Feature}}Page, serialize{{Feature}}BulkResults } from '../serializers/{{feature}}.serializer';
+
+// The {{Feature}}Controller routes for {{server_entry}}: the same use cases, validators and serializers behind a
+// framework-free request and response. POST /import streams its body and is served by Server/index.ts only.
+@injectable()
+export class {{Feature}}Handler implements FeatureHandler {
+  constructor(
+    @inject('Create{{Feature}}UseCase') private create{{Feature}}UseCase: Create{{Feature}}UseCase,
+    @inject('CreateMany{{Feature}}UseCase') private createMany{{Feature}}UseCase: CreateMany{{Feature}}UseCase,
+    @inject('List{{Feature}}UseCase') private list{{Feature}}UseCase: List{{Feature}}UseCase,
+    @inject('Update{{Feature}}UseCase') private update{{Feature}}UseCase: Update{{Feature}}UseCase,
+    @inject('Delete{{Feature}}UseCase') private delete{{Feature}}UseCase: Delete{{Feature}}UseCase
+  ) {}
+
+  async handle(request: HttpRequest, route: string): Promise<HttpResponse | null> {
+    if (route === '/') {
+      if (request.method === 'GET') return this.list{{Feature}}(request);
+      if (request.method === 'POST') return this.create{{Feature}}(request);
+      return null;
+    }
+    if (route === '/bulk') return request.method === 'POST' ? this.createMany{{Feature}}(request) : null;
+    if (route.indexOf('/', 1) !== -1) return null;
+    const id = decodeURIComponent(route.slice(1));
+    if (request.method === 'PATCH') return this.update{{Feature}}(request, id);
+    if (request.method === 'DELETE') return this.delete{{Feature}}(request, id);
+    return null;
+  }
+
+  private async create{{Feature}}(request: HttpRequest): Promise<HttpResponse> {
+    const body = parseJson(request);
+    if (body.isErr()) return errorResponse(body.unwrapErr());
+    const message = validate{{Feature}}Record(body.unwrap());
+    if (message !== null) return errorResponse(new CustomError(400, message));
+    const result = await this.create{{Feature}}UseCase.execute(body.unwrap() as Create{{Feature}}Dto);
+    if (result.isErr()) return errorResponse(result.unwrapErr());
+    return jsonResponse(201, serialize{{Feature}}(result.unwrap()));
+  }
+
+  private async createMany{{Feature}}(request: HttpRequest): Promise<HttpResponse> {
+    const body = parseJson(request);
+    if (body.isErr()) return errorResponse(body.unwrapErr());
+    const dtos = body.unwrap();
+    const maxItems = Number(process.env.BULK_MAX_ITEMS) || 10000;
+    if (Array.isArray(dtos) && dtos.length > maxItems) {
+      return errorResponse(new CustomError(413, 'Bulk requests are limited to ' + maxItems + ' items'));
+    }
+    if (!Array.isArray(dtos) || dtos.length === 0) return errorResponse(new CustomError(400, 'body must be a non-empty array'));
+    for (let index = 0; index < dtos.length; index++) {
+      const message = validate{{Feature}}Record(dtos[index]);
+      if (message !== null) return errorResponse(new CustomError(400, index + '.' + message));
+    }
+    const result = await this.createMany{{Feature}}UseCase.execute(dtos as Create{{Feature}}Dto[]);
+    if (result.isErr()) return errorResponse(result.unwrapErr());
+    const results = result.unwrap();
+    const failed = results.filter((item) => item.isErr()).length;
+    return jsonResponse(failed === 0 ? 201 : 207, serialize{{Feature}}BulkResults(results, failed));
+  }
+
+  private async list{{Feature}}(request: HttpRequest): Promise<HttpResponse> {
+    const cursor = request.query.cursor ?? null;
+    const limit = request.query.limit ? Number(request.query.limit) : undefined;
+    const result = await this.list{{Feature}}UseCase.execute(cursor, limit);
+    if (result.isErr()) return errorResponse(result.unwrapErr());
+    return jsonResponse(200, serialize{{Feature}}Page(result.unwrap()));
+  }
+
+  private async update{{Feature}}(request: HttpRequest, id: string): Promise<HttpResponse> {
+    const expectedVersion = ifMatchVersion(request.headers['if-match']);
+    if (Number.isNaN(expectedVersion)) return errorResponse(new CustomError(400, 'If-Match must be a version number'));
+    const body = parseJson(request);
+    if (body.isErr()) return errorResponse(body.unwrapErr());
+    {{handler_validate_patch}}
+    if (message !== null) return errorResponse(new CustomError(400, message));
+    const result = await this.update{{Feature}}UseCase.execute(id, body.unwrap() as Update{{Feature}}Dto, expectedVersion);
+    if (result.isErr()) return errorResponse(result.unwrapErr());
+    return jsonResponse(200, serialize{{Feature}}(result.unwrap()));
+  }
+
+  private async delete{{Feature}}(request: HttpRequest, id: string): Promise<HttpResponse> {
+    const expectedVersion = ifMatchVersion(request.headers['if-match']);
+    if (Number.isNaN(expectedVersion)) return errorResponse(new CustomError(400, 'If-Match must be a version number'));
+    const result = await this.delete{{Feature}}UseCase.execute(id, expectedVersion);
+    if (result.isErr()) return errorResponse(result.unwrapErr());
+    return emptyResponse(204);
+  }
+}
@@ -0,0 +1,17 @@
+import { injectable, inject } from 'tsyringe';
+import { {{Feature}}Repository, {{Feature}}Page } from '../repositories/{{feature}}.repository.interface';
+import { Result } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';{{metrics_import useCaseDuration}}{{tracing_import}}
+
+export const DEFAULT_PAGE_SIZE = 20;
+export const MAX_PAGE_SIZE = 100;
+
+@injectable()
+export class List{{Feature}}UseCase {
+  constructor(@inject('{{Feature}}Repository') private {{feature}}Repository: {{Feature}}Repository) {}
+
+  {{timed useCaseDuration List{Feature}UseCase}}{{traced List{Feature}UseCase.execute}}async execute(cursor: string | null, limit?: number): Promise<Result<{{Feature}}Page, CustomError>> {
+    const pageSize = Math.min(Math.max(Math.floor(limit || DEFAULT_PAGE_SIZE), 1), MAX_PAGE_SIZE);
+    return await this.{{feature}}Repository.findPage(cursor, pageSize);
+  }
+}
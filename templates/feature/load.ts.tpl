@@ -0,0 +1,37 @@
+// Load scenarios for /api/{{feature}}, built from the generated sample record. Run with: npm run bench
+import type { LoadScenario } from './run';
+
+const BULK_SIZE = Number(process.env.BENCH_BULK_SIZE) || 100;
+const IMPORT_LINES = Number(process.env.BENCH_IMPORT_LINES) || 1000;
+
+const sample = {{sample}};
+{{load_record}}
+
+export const scenarios: LoadScenario[] = [
+  {
+    name: '{{feature}} create',
+    method: 'POST',
+    path: '/api/{{feature}}',
+    headers: { 'content-type': 'application/json' },
+    body: {{load_body}}JSON.stringify(record()),
+  },
+  {
+    name: '{{feature}} bulk',
+    method: 'POST',
+    path: '/api/{{feature}}/bulk',
+    headers: { 'content-type': 'application/json' },
+    body: {{load_body}}JSON.stringify(Array.from({ length: BULK_SIZE }, record)),
+  },
+  {
+    name: '{{feature}} import',
+    method: 'POST',
+    path: '/api/{{feature}}/import',
+    headers: { 'content-type': 'application/x-ndjson' },
+    body: {{load_body}}Array.from({ length: IMPORT_LINES }, () => JSON.stringify(record())).join('\n'),
+  },
+  {
+    name: '{{feature}} list',
+    method: 'GET',
+    path: '/api/{{feature}}?limit=20',
+  },
+];
@@ -0,0 +1,15 @@
+import mongoose, { Schema, Document } from 'mongoose';
+
+export interface I{{Feature}} extends Document {
+  {{model_id_type}}
+  {{entity_fields}};
+  version: number;
+}
+
+const {{Feature}}Schema: Schema = new Schema({
+  {{model_id_field}}
+  {{model_fields}}
+  version: { type: Number, default: 0 },
+});
+{{schema_indexes}}
+export const {{Feature}}Model = mongoose.model<I{{Feature}}>('{{Feature}}', {{Feature}}Schema);
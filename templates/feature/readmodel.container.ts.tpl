@@ -0,0 +1,18 @@
+import 'reflect-metadata';
+import { {{tsyringe_imports}} } from 'tsyringe';
+import { {{Feature}}Controller } from './delivery/controllers/{{feature}}.controller';
+import { Query{{Feature}}UseCase } from './domain/usecases/query-{{feature}}.usecase';
+import { Refresh{{Feature}}UseCase } from './domain/usecases/refresh-{{feature}}.usecase';
+import { {{Feature}}RepositoryImpl } from './data/repositories/{{feature}}.repository';
+import { {{Feature}}DataSource } from './data/datasources/{{feature}}.datasource';
+import { {{Feature}}Projector } from './data/projections/{{feature}}.projection';
+
+{{di_register 'Query{Feature}UseCase' Query{Feature}UseCase}}
+{{di_register 'Refresh{Feature}UseCase' Refresh{Feature}UseCase}}
+{{di_register '{Feature}Repository' {Feature}RepositoryImpl}}
+{{di_register '{Feature}DataSource' {Feature}DataSource}}
+{{di_register {Feature}Controller {Feature}Controller}}
+// One projector per process whatever the DI scope: it owns the change stream and the rebuild schedule
+container.registerSingleton({{Feature}}Projector);
+
+export { container };
@@ -0,0 +1,47 @@
+import { injectable, inject } from 'tsyringe';
+import { Request, Response } from 'express';
+import { Router } from 'express';
+import { Query{{Feature}}UseCase } from '../../domain/usecases/query-{{feature}}.usecase';
+import { Refresh{{Feature}}UseCase } from '../../domain/usecases/refresh-{{feature}}.usecase';
+import { {{Feature}}Filter } from '../../domain/repositories/{{feature}}.repository.interface';{{metrics_import handlerDuration}}{{tracing_import}}{{protect_import}}{{query_value_parser}}
+
+@injectable()
+export class {{Feature}}Controller {
+  private router: Router;
+
+  constructor(
+    @inject('Query{{Feature}}UseCase') private query{{Feature}}UseCase: Query{{Feature}}UseCase,
+    @inject('Refresh{{Feature}}UseCase') private refresh{{Feature}}UseCase: Refresh{{Feature}}UseCase
+  ) {
+    this.router = Router();{{shed_load}}
+    this.router.get('/', {{rate_limited {feature}.query}}this.query{{Feature}}.bind(this));
+    this.router.post('/refresh', {{rate_limited {feature}.refresh}}this.refresh{{Feature}}.bind(this));
+  }
+{{query_comment}}
+  {{timed handlerDuration {Feature}Controller.query{Feature}}}{{traced {Feature}Controller.query{Feature}}}async query{{Feature}}(req: Request, res: Response): Promise<void> {
+    const filter: {{Feature}}Filter = {};{{express_filters}}
+    const cursor = typeof req.query.cursor === 'string' ? req.query.cursor : null;
+    const limit = req.query.limit ? Number(req.query.limit) : undefined;
+    const result = await this.query{{Feature}}UseCase.execute(filter, cursor, limit);
+    if (result.isOk()) {
+      res.status(200).json(result.unwrap());
+    } else {
+      const error = result.unwrapErr();
+      res.status(error.statusCode).json({ message: error.message });
+    }
+  }
+
+  {{timed handlerDuration {Feature}Controller.refresh{Feature}}}{{traced {Feature}Controller.refresh{Feature}}}async refresh{{Feature}}(req: Request, res: Response): Promise<void> {
+    const result = await this.refresh{{Feature}}UseCase.execute();
+    if (result.isOk()) {
+      res.status(202).json({ requestedAt: result.unwrap() });
+    } else {
+      const error = result.unwrapErr();
+      res.status(error.statusCode).json({ message: error.message });
+    }
+  }
+
+  getRouter(): Router {
+    return this.router;
+  }
+}
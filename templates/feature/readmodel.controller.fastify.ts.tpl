@@ -0,0 +1,55 @@
+import { injectable, inject } from 'tsyringe';
+import { FastifyInstance, FastifyRequest, FastifyReply } from 'fastify';
+import { Query{{Feature}}UseCase } from '../../domain/usecases/query-{{feature}}.usecase';
+import { Refresh{{Feature}}UseCase } from '../../domain/usecases/refresh-{{feature}}.usecase';
+import { {{Feature}}Filter } from '../../domain/repositories/{{feature}}.repository.interface';{{metrics_import handlerDuration}}{{tracing_import}}{{protect_import}}
+
+type {{Feature}}Query = {{Feature}}Filter & { cursor?: string; limit?: number };{{query_value_parser}}
+
+// Unknown query parameters are stripped rather than passed on as filters
+const querySchema = {
+  querystring: {
+    type: 'object',
+    properties: { {{query_properties}}cursor: { type: 'string' }, limit: { type: 'integer', minimum: 1 } },
+    additionalProperties: false,
+  },
+};
+
+const refreshSchema = {
+  response: { 202: { type: 'object', properties: { requestedAt: { type: 'string', format: 'date-time' } } } },
+};
+
+@injectable()
+export class {{Feature}}Controller {
+  constructor(
+    @inject('Query{{Feature}}UseCase') private query{{Feature}}UseCase: Query{{Feature}}UseCase,
+    @inject('Refresh{{Feature}}UseCase') private refresh{{Feature}}UseCase: Refresh{{Feature}}UseCase
+  ) {}
+
+  // Fastify plugin, registered by Server/index.ts under /api/{{feature}}
+  routes = async (app: FastifyInstance): Promise<void> => {{{shed_load}}
+    app.get('/', { {{rate_limited {feature}.query}}schema: querySchema }, this.query{{Feature}}.bind(this));
+    app.post('/refresh', { {{rate_limited {feature}.refresh}}schema: refreshSchema }, this.refresh{{Feature}}.bind(this));
+  };
+{{query_comment}}
+  {{timed handlerDuration {Feature}Controller.query{Feature}}}{{traced {Feature}Controller.query{Feature}}}async query{{Feature}}(request: FastifyRequest<{ Querystring: {{Feature}}Query }>, reply: FastifyReply): Promise<void> {
+    const { cursor, limit, ...filter } = request.query;{{fastify_filters}}
+    const result = await this.query{{Feature}}UseCase.execute(filter, cursor ?? null, limit);
+    if (result.isOk()) {
+      reply.code(200).send(result.unwrap());
+    } else {
+      const error = result.unwrapErr();
+      reply.code(error.statusCode).send({ message: error.message });
+    }
+  }
+
+  {{timed handlerDuration {Feature}Controller.refresh{Feature}}}{{traced {Feature}Controller.refresh{Feature}}}async refresh{{Feature}}(request: FastifyRequest, reply: FastifyReply): Promise<void> {
+    const result = await this.refresh{{Feature}}UseCase.execute();
+    if (result.isOk()) {
+      reply.code(202).send({ requestedAt: result.unwrap() });
+    } else {
+      const error = result.unwrapErr();
+      reply.code(error.statusCode).send({ message: error.message });
+    }
+  }
+}
@@ -0,0 +1,53 @@
+import { injectable, inject } from 'tsyringe';
+import { {{Feature}} } from '../../domain/entity/{{feature}}.entity';
+import { {{Feature}}Filter, {{Feature}}Page } from '../../domain/repositories/{{feature}}.repository.interface';
+import { {{Feature}}Model, I{{Feature}} } from '../models/{{feature}}.model';
+import { {{Feature}}Projector } from '../projections/{{feature}}.projection';
+import { Result, Ok, Err } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';{{metrics_import dataSourceDuration}}{{tracing_import}}
+
+type PageCursor = { id: unknown };
+
+const encodeCursor = (cursor: PageCursor): string => Buffer.from(JSON.stringify(cursor)).toString('base64url');
+
+const decodeCursor = (cursor: string): PageCursor | null => {
+  try {
+    const decoded = JSON.parse(Buffer.from(cursor, 'base64url').toString());
+    return decoded !== null && typeof decoded === 'object' && 'id' in decoded ? decoded : null;
+  } catch {
+    return null;
+  }
+};
+
+// Reads the materialized rows only; nothing here aggregates {{source}} per request
+@injectable()
+export class {{Feature}}DataSource {
+  constructor(@inject({{Feature}}Projector) private projector: {{Feature}}Projector) {}
+
+  {{timed dataSourceDuration {feature}.find}}{{traced {Feature}DataSource.find}}async find(filter: {{Feature}}Filter, cursor: string | null, limit: number): Promise<Result<{{Feature}}Page, CustomError>> {
+    const after = cursor ? decodeCursor(cursor) : null;
+    if (cursor && !after) return Err(new CustomError(400, 'Invalid cursor'));
+    try {
+      const rows = await {{Feature}}Model.find(after ? { ...filter, _id: { $gt: after.id } } : filter)
+        .sort({ _id: 1 })
+        .limit(limit + 1)
+        .lean<I{{Feature}}[]>();
+      const hasMore = rows.length > limit;
+      const page = hasMore ? rows.slice(0, limit) : rows;
+      const items = page.map((doc) => new {{Feature}}({{doc_args}}doc.refreshedAt));
+      const nextCursor = hasMore ? encodeCursor({ id: page[page.length - 1]._id }) : null;
+      return Ok({ items, nextCursor });
+    } catch (error) {
+      return Err(new CustomError(500, 'Failed to query {{feature}}: ' + (error as Error).message));
+    }
+  }
+
+  {{timed dataSourceDuration {feature}.requestRebuild}}{{traced {Feature}DataSource.requestRebuild}}async requestRebuild(): Promise<Result<Date, CustomError>> {
+    try {
+      const requestedAt = await this.projector.requestRebuild();
+      return requestedAt ? Ok(requestedAt) : Err(new CustomError(429, 'A {{feature}} rebuild was requested recently'));
+    } catch (error) {
+      return Err(new CustomError(500, 'Failed to request a {{feature}} rebuild: ' + (error as Error).message));
+    }
+  }
+}
@@ -0,0 +1,8 @@
+// One precomputed row of the {{feature}} read model: the {{source}} documents sharing its group keys, counted and totalled
+export class {{Feature}} {
+  constructor(
+    {{entity_params}}
+    // When the row was last recomputed from {{source}}
+    public refreshedAt: Date
+  ) {}
+}
@@ -0,0 +1,19 @@
+import mongoose, { Schema } from 'mongoose';
+
+// _id is the group key written by the $merge stage in data/projections; the keys are repeated as fields for filtering
+export interface I{{Feature}} {
+  _id: unknown;
+  {{model_types}}
+  refreshedAt: Date;
+}
+
+const {{Feature}}Schema = new Schema<I{{Feature}}>(
+  {
+    _id: { type: Schema.Types.Mixed },
+    {{model_fields}}
+    refreshedAt: { type: Date, required: true },
+  },
+  { versionKey: false }
+);
+{{schema_indexes}}
+export const {{Feature}}Model = mongoose.model<I{{Feature}}>('{{Feature}}', {{Feature}}Schema);
@@ -0,0 +1,177 @@
+import { injectable } from 'tsyringe';
+import mongoose, { PipelineStage } from 'mongoose';
+import { {{Feature}}Model } from '../models/{{feature}}.model';
+import { {{Source}}Model } from '../../../{{source}}/data/models/{{source}}.model';
+
+type SourceChange = mongoose.mongo.ChangeStreamDocument<Record<string, unknown>>;
+
+// Rebuilds asked for by POST /refresh, which any process may serve: the request is recorded here, in a collection
+// shared by the read models, and the projector picks it up, so the single-projector rule (READMODEL_REFRESH) holds
+const rebuildRequests = () => mongoose.connection.collection<{ _id: string; requestedAt: Date }>('readmodel_rebuilds');
+
+// Group keys of the read model; with none there is a single row and every change rebuilds it
+const KEY_FIELDS: string[] = [{{key_list}}];
+
+// The _id of the row a {{source}} document is counted in, as built by the $group stage
+const keyOf = (doc: Record<string, unknown>): unknown => {{key_of}};
+
+// The {{source}} documents counted in the row with that _id
+const matchOf = (key: unknown): Record<string, unknown> => {{match_of}};
+
+// Recomputes the rows for the {{source}} documents matching "match" (all of them by default) and upserts them by _id
+export const {{feature}}Pipeline = (refreshedAt: Date, match?: Record<string, unknown>): PipelineStage[] => [
+  ...(match ? [{ $match: match }] : []),
+  { $group: { _id: {{group_id}}, count: { $sum: 1 }{{group_totals}} } },
+  { $set: { {{set_keys}}refreshedAt } },
+  {
+    $merge: { into: {{Feature}}Model.collection.collectionName, on: '_id', whenMatched: 'replace', whenNotMatched: 'insert' },
+  },
+];
+
+// Keeps the {{feature}} collection in step with {{source}}: a full rebuild every READMODEL_REBUILD_MS, plus incremental
+// refreshes of the touched groups from a change stream (replica sets only) batched over READMODEL_DEBOUNCE_MS.
+// Refreshes run one at a time, and the server starts a single projector per deployment (READMODEL_REFRESH), which
+// also runs the rebuilds requested from any process every READMODEL_REQUEST_POLL_MS.
+@injectable()
+export class {{Feature}}Projector {
+  private queue: Promise<unknown> = Promise.resolve();
+  private pending = new Map<string, unknown>();
+  private pendingRebuild = false;
+  private flushTimer: NodeJS.Timeout | null = null;
+  private timers: NodeJS.Timeout[] = [];
+  private changes: mongoose.mongo.ChangeStream<Record<string, unknown>, SourceChange> | null = null;
+
+  // Rows are stamped with the run's time, so a row older than the run belongs to a group that no longer exists
+  rebuild(): Promise<number> {
+    return this.schedule(async () => {
+      const refreshedAt = new Date();
+      await {{Source}}Model.aggregate({{feature}}Pipeline(refreshedAt));
+      await {{Feature}}Model.deleteMany({ refreshedAt: { $lt: refreshedAt } });
+      return {{Feature}}Model.countDocuments();
+    });
+  }
+
+  refresh(keys: unknown[]): Promise<void> {
+    return this.schedule(async () => {
+      const refreshedAt = new Date();
+      await {{Source}}Model.aggregate({{feature}}Pipeline(refreshedAt, { $or: keys.map(matchOf) }));
+      await {{Feature}}Model.deleteMany({ _id: { $in: keys }, refreshedAt: { $lt: refreshedAt } });
+    });
+  }
+
+  // Records a rebuild request for the projector and resolves to its time, or to null when the last one is less than
+  // READMODEL_REFRESH_MIN_INTERVAL_MS old: the limit is deployment-wide, so the full rebuild stays rare whoever asks
+  async requestRebuild(): Promise<Date | null> {
+    const requestedAt = new Date();
+    const minIntervalMs = Number(process.env.READMODEL_REFRESH_MIN_INTERVAL_MS ?? 60000);
+    try {
+      await rebuildRequests().updateOne(
+        { _id: '{{feature}}', requestedAt: { $lte: new Date(requestedAt.getTime() - minIntervalMs) } },
+        { $set: { requestedAt } },
+        { upsert: true }
+      );
+      return requestedAt;
+    } catch (error) {
+      // A recent request does not match the filter, so the upsert collides with it on _id
+      if ((error as { code?: number }).code === 11000) return null;
+      throw error;
+    }
+  }
+
+  // Returns the stop hook for drainOnShutdown
+  start(): () => Promise<void> {
+    const rebuild = () => this.rebuild().catch((error) => console.error('Failed to rebuild {{feature}}:', error));
+    rebuild();
+    const every = Number(process.env.READMODEL_REBUILD_MS ?? 300000);
+    if (every > 0) this.timers.push(setInterval(rebuild, every).unref());
+    // The first poll only notes the latest request: the rebuild above covers it
+    let seen: number | null = null;
+    const poll = () =>
+      rebuildRequests()
+        .findOne({ _id: '{{feature}}' })
+        .then((request) => {
+          const requestedAt = request?.requestedAt.getTime() ?? 0;
+          if (seen !== null && requestedAt > seen) rebuild();
+          seen = requestedAt;
+        })
+        .catch((error) => console.warn('Failed to check {{feature}} rebuild requests:', error.message));
+    poll();
+    this.timers.push(setInterval(poll, Number(process.env.READMODEL_REQUEST_POLL_MS) || 5000).unref());
+    // With changeStreamPreAndPostImages enabled on the source collection, deletes and key changes are incremental too
+    this.changes = {{Source}}Model.watch<Record<string, unknown>, SourceChange>([], {
+      fullDocument: 'updateLookup',
+      fullDocumentBeforeChange: 'whenAvailable',
+    })
+      .on('change', (change: SourceChange) => this.track(change))
+      .on('error', (error) => console.warn('{{feature}} change stream closed; refreshing on schedule only:', error.message));
+    return () => this.stop();
+  }
+
+  // Closes the change stream, drops the changes not yet flushed (the next start rebuilds anyway) and waits for the
+  // refresh in flight, so nothing is left using the connection
+  private async stop(): Promise<void> {
+    this.timers.forEach(clearInterval);
+    this.timers = [];
+    if (this.flushTimer) clearTimeout(this.flushTimer);
+    this.flushTimer = null;
+    this.pending.clear();
+    this.pendingRebuild = false;
+    await this.changes?.close();
+    this.changes = null;
+    await this.queue;
+  }
+
+  private track(change: SourceChange): void {
+    const touched: Record<string, unknown>[] = [];
+    let complete = KEY_FIELDS.length > 0;
+    switch (change.operationType) {
+      case 'insert':
+        touched.push(change.fullDocument);
+        break;
+      case 'update':
+      case 'replace': {
+        if (change.fullDocument) touched.push(change.fullDocument);
+        else complete = false;
+        // An update that leaves every key alone keeps the document in its group, so the post-image is enough
+        const description = change.operationType === 'update' ? change.updateDescription : undefined;
+        const keysKept =
+          description !== undefined &&
+          !KEY_FIELDS.some((field) => field in (description.updatedFields ?? {}) || description.removedFields?.includes(field));
+        if (change.fullDocumentBeforeChange) touched.push(change.fullDocumentBeforeChange);
+        else if (!keysKept) complete = false;
+        break;
+      }
+      case 'delete':
+        if (change.fullDocumentBeforeChange) touched.push(change.fullDocumentBeforeChange);
+        else complete = false;
+        break;
+      default:
+        complete = false;
+    }
+    if (complete) {
+      for (const doc of touched) {
+        const key = keyOf(doc);
+        this.pending.set(JSON.stringify(key), key);
+      }
+    } else {
+      this.pendingRebuild = true;
+    }
+    this.flushTimer ??= setTimeout(() => this.flush(), Number(process.env.READMODEL_DEBOUNCE_MS) || 1000);
+  }
+
+  private flush(): void {
+    const keys = [...this.pending.values()];
+    const full = this.pendingRebuild;
+    this.pending.clear();
+    this.pendingRebuild = false;
+    this.flushTimer = null;
+    const job = full ? this.rebuild() : this.refresh(keys);
+    job.catch((error) => console.error('Failed to refresh {{feature}}:', error));
+  }
+
+  private schedule<T>(job: () => Promise<T>): Promise<T> {
+    const run = this.queue.then(job, job);
+    this.queue = run.catch(() => undefined);
+    return run;
+  }
+}
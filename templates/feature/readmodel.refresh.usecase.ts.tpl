@@ -0,0 +1,15 @@
+import { injectable, inject } from 'tsyringe';
+import { {{Feature}}Repository } from '../repositories/{{feature}}.repository.interface';
+import { Result } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';{{metrics_import useCaseDuration}}{{tracing_import}}
+
+// Asks the projector to rebuild the whole read model instead of waiting for the next scheduled run; resolves to the
+// time of the request, which the projector picks up within READMODEL_REQUEST_POLL_MS
+@injectable()
+export class Refresh{{Feature}}UseCase {
+  constructor(@inject('{{Feature}}Repository') private {{feature}}Repository: {{Feature}}Repository) {}
+
+  {{timed useCaseDuration Refresh{Feature}UseCase}}{{traced Refresh{Feature}UseCase.execute}}async execute(): Promise<Result<Date, CustomError>> {
+    return await this.{{feature}}Repository.requestRebuild();
+  }
+}
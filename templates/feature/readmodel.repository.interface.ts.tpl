@@ -0,0 +1,17 @@
+import { Result } from '../../../../Core/result/result';
+import { {{Feature}} } from '../entity/{{feature}}.entity';
+import { CustomError } from '../../../../Core/error/custom-error';
+
+// Rows can be filtered on any combination of their group keys
+export type {{Feature}}Filter = Partial<Pick<{{Feature}}, {{key_union}}>>;
+
+export interface {{Feature}}Page {
+  items: {{Feature}}[];
+  nextCursor: string | null;
+}
+
+// The read model is written only by its projector; callers query it or ask for a rebuild
+export interface {{Feature}}Repository {
+  find(filter: {{Feature}}Filter, cursor: string | null, limit: number): Promise<Result<{{Feature}}Page, CustomError>>;
+  requestRebuild(): Promise<Result<Date, CustomError>>;
+}
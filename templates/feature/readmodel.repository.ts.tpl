@@ -0,0 +1,18 @@
+import { injectable, inject } from 'tsyringe';
+import { {{Feature}}Repository, {{Feature}}Filter, {{Feature}}Page } from '../../domain/repositories/{{feature}}.repository.interface';
+import { {{Feature}}DataSource } from '../datasources/{{feature}}.datasource';
+import { Result } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';{{tracing_import}}
+
+@injectable()
+export class {{Feature}}RepositoryImpl implements {{Feature}}Repository {
+  constructor(@inject('{{Feature}}DataSource') private dataSource: {{Feature}}DataSource) {}
+
+  {{traced {Feature}Repository.find}}async find(filter: {{Feature}}Filter, cursor: string | null, limit: number): Promise<Result<{{Feature}}Page, CustomError>> {
+    return await this.dataSource.find(filter, cursor, limit);
+  }
+
+  {{traced {Feature}Repository.requestRebuild}}async requestRebuild(): Promise<Result<Date, CustomError>> {
+    return await this.dataSource.requestRebuild();
+  }
+}
@@ -0,0 +1,71 @@
+import { container } from '../../../Features/{{feature}}/container';
+import { Query{{Feature}}UseCase, MAX_PAGE_SIZE } from '../../../Features/{{feature}}/domain/usecases/query-{{feature}}.usecase';
+import { Refresh{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/refresh-{{feature}}.usecase';
+import { {{Feature}}Repository } from '../../../Features/{{feature}}/domain/repositories/{{feature}}.repository.interface';
+import { {{feature}}Pipeline } from '../../../Features/{{feature}}/data/projections/{{feature}}.projection';
+import { Ok, Err } from '../../../Core/result/result';
+import { CustomError } from '../../../Core/error/custom-error';
+import { {{Feature}} } from '../../../Features/{{feature}}/domain/entity/{{feature}}.entity';
+
+describe('{{feature}}Pipeline', () => {
+  const refreshedAt = new Date('2024-01-01T00:00:00Z');
+
+  it('should group {{source}} and merge the rows into the read model by _id', () => {
+    const stages = {{feature}}Pipeline(refreshedAt);
+
+    expect(stages.map((stage) => Object.keys(stage)[0])).toEqual(['$group', '$set', '$merge']);
+    expect(stages[0]).toEqual({ $group: { _id: {{group_id}}, count: { $sum: 1 }{{group_totals}} } });
+    expect(stages[2]).toMatchObject({ $merge: { on: '_id', whenMatched: 'replace', whenNotMatched: 'insert' } });
+  });
+
+  it('should only read the matched {{source}} documents on an incremental refresh', () => {
+    const match = { $or: [{{match_example}}] };
+
+    expect({{feature}}Pipeline(refreshedAt, match)[0]).toEqual({ $match: match });
+  });
+});
+
+describe('{{feature}} use cases', () => {
+  let query{{Feature}}UseCase: Query{{Feature}}UseCase;
+  let mockRepository: jest.Mocked<{{Feature}}Repository>;
+
+  beforeEach(() => {
+    mockRepository = {
+      find: jest.fn(),
+      requestRebuild: jest.fn(),
+    };
+    container.registerInstance('{{Feature}}Repository', mockRepository);
+    query{{Feature}}UseCase = container.resolve<Query{{Feature}}UseCase>('Query{{Feature}}UseCase');
+  });
+
+  afterEach(() => {
+    container.clearInstances();
+  });
+
+  it('should read a page of precomputed rows', async () => {
+    const page = { items: [new {{Feature}}({{sample_args}}new Date())], nextCursor: null };
+    mockRepository.find.mockResolvedValue(Ok(page));
+
+    const result = await query{{Feature}}UseCase.execute({{filter_sample}}, null);
+
+    expect(result.unwrap()).toEqual(page);
+    expect(mockRepository.find).toHaveBeenCalledWith({{filter_sample}}, null, 20);
+  });
+
+  it('should clamp the page size', async () => {
+    mockRepository.find.mockResolvedValue(Ok({ items: [], nextCursor: null }));
+
+    await query{{Feature}}UseCase.execute({}, null, 10000);
+
+    expect(mockRepository.find).toHaveBeenCalledWith({}, null, MAX_PAGE_SIZE);
+  });
+
+  it('should pass a refused rebuild request through', async () => {
+    const error = new CustomError(429, 'A {{feature}} rebuild was requested recently');
+    mockRepository.requestRebuild.mockResolvedValue(Err(error));
+
+    const result = await container.resolve<Refresh{{Feature}}UseCase>('Refresh{{Feature}}UseCase').execute();
+
+    expect(result.unwrapErr()).toEqual(error);
+  });
+});
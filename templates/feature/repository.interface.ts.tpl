@@ -0,0 +1,21 @@
+import { Result } from '../../../../Core/result/result';
+import { {{Feature}} } from '../entity/{{feature}}.entity';
+import { CustomError } from '../../../../Core/error/custom-error';
+
+export interface {{Feature}}Page {
+  items: {{Feature}}[];
+  nextCursor: string | null;
+}
+
+// The fields an update may change; id and version are managed by the datasource
+export type {{Feature}}Changes = Partial<Omit<{{Feature}}, 'id' | 'version'>>;
+
+export interface {{Feature}}Repository {
+  create({{feature}}: {{Feature}}): Promise<Result<{{Feature}}, CustomError>>;
+  createMany({{feature}}List: {{Feature}}[]): Promise<Result<Result<{{Feature}}, CustomError>[], CustomError>>;
+  findById(id: string): Promise<Result<{{Feature}} | null, CustomError>>;
+  findPage(cursor: string | null, limit: number): Promise<Result<{{Feature}}Page, CustomError>>;
+  // Both resolve to Ok(null) / Ok(false) for an unknown id, and to a 412 Err when expectedVersion is stale
+  update(id: string, changes: {{Feature}}Changes, expectedVersion?: number): Promise<Result<{{Feature}} | null, CustomError>>;
+  delete(id: string, expectedVersion?: number): Promise<Result<boolean, CustomError>>;
+}
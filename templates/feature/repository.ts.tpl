@@ -0,0 +1,35 @@
+import { injectable, inject } from 'tsyringe';
+import { {{Feature}} } from '../../domain/entity/{{feature}}.entity';
+import { {{Feature}}Repository, {{Feature}}Page, {{Feature}}Changes } from '../../domain/repositories/{{feature}}.repository.interface';
+import { {{Feature}}DataSource } from '../datasources/{{feature}}.datasource';
+import { Result } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';{{tracing_import}}
+
+@injectable()
+export class {{Feature}}RepositoryImpl implements {{Feature}}Repository {
+  constructor(@inject('{{Feature}}DataSource') private dataSource: {{Feature}}DataSource) {}
+
+  {{traced {Feature}Repository.create}}async create({{feature}}: {{Feature}}): Promise<Result<{{Feature}}, CustomError>> {
+    return await this.dataSource.create({{feature}});
+  }
+
+  {{traced {Feature}Repository.createMany}}async createMany({{feature}}List: {{Feature}}[]): Promise<Result<Result<{{Feature}}, CustomError>[], CustomError>> {
+    return await this.dataSource.createMany({{feature}}List);
+  }
+
+  {{traced {Feature}Repository.findById}}async findById(id: string): Promise<Result<{{Feature}} | null, CustomError>> {
+    return await this.dataSource.findById(id);
+  }
+
+  {{traced {Feature}Repository.findPage}}async findPage(cursor: string | null, limit: number): Promise<Result<{{Feature}}Page, CustomError>> {
+    return await this.dataSource.findPage(cursor, limit);
+  }
+
+  {{traced {Feature}Repository.update}}async update(id: string, changes: {{Feature}}Changes, expectedVersion?: number): Promise<Result<{{Feature}} | null, CustomError>> {
+    return await this.dataSource.update(id, changes, expectedVersion);
+  }
+
+  {{traced {Feature}Repository.delete}}async delete(id: string, expectedVersion?: number): Promise<Result<boolean, CustomError>> {
+    return await this.dataSource.delete(id, expectedVersion);
+  }
+}
@@ -0,0 +1,75 @@
+// JSON schemas for the {{feature}} routes, generated from --fields. Fastify validates requests against them with Ajv
+// and compiles the response schemas into fast-json-stringify serializers, so no route calls JSON.stringify.
+const {{feature}}Properties = {{{json_properties}}
+};
+
+const {{feature}}Body = { type: 'object', required: [{{json_required}}], properties: {{feature}}Properties };
+const {{feature}}Entity = { type: 'object', properties: { id: { type: 'string' }, ...{{feature}}Properties, version: { type: 'integer' } } };
+const {{feature}}Params = { type: 'object', required: ['id'], properties: { id: { type: 'string' } } };
+const errorResponse = { type: 'object', properties: { message: { type: 'string' } } };
+const errorResponses = { '4xx': errorResponse, '5xx': errorResponse };
+
+export const {{feature}}RouteSchemas = {
+  create: {
+    body: {{feature}}Body,
+    response: { 201: {{feature}}Entity, ...errorResponses },
+  },
+  bulk: {
+    body: { type: 'array', minItems: 1, items: {{feature}}Body },
+    response: {
+      '2xx': {
+        type: 'object',
+        properties: {
+          inserted: { type: 'integer' },
+          failed: { type: 'integer' },
+          results: {
+            type: 'array',
+            items: {
+              type: 'object',
+              properties: {
+                kind: { type: 'string' },
+                value: {{feature}}Entity,
+                error: { type: 'object', properties: { statusCode: { type: 'integer' }, message: { type: 'string' } } },
+              },
+            },
+          },
+        },
+      },
+      ...errorResponses,
+    },
+  },
+  import: {
+    response: {
+      '2xx': {
+        type: 'object',
+        properties: {
+          received: { type: 'integer' },
+          inserted: { type: 'integer' },
+          failed: { type: 'integer' },
+          errors: {
+            type: 'array',
+            items: { type: 'object', properties: { record: { type: 'integer' }, message: { type: 'string' } } },
+          },
+        },
+      },
+      ...errorResponses,
+    },
+  },
+  update: {
+    params: {{feature}}Params,
+    // propertyNames rather than additionalProperties: false, which Fastify's removeAdditional would strip silently
+    body: { type: 'object', minProperties: 1, propertyNames: { enum: [{{patch_fields}}] }, properties: {{feature}}Properties },
+    response: { 200: {{feature}}Entity, ...errorResponses },
+  },
+  delete: {
+    params: {{feature}}Params,
+    response: errorResponses,
+  },
+  list: {
+    querystring: { type: 'object', properties: { cursor: { type: 'string' }, limit: { type: 'integer', minimum: 1 } } },
+    response: {
+      200: { type: 'object', properties: { items: { type: 'array', items: {{feature}}Entity }, nextCursor: { type: ['string', 'null'] } } },
+      ...errorResponses,
+    },
+  },
+};
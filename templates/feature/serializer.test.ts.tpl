@@ -0,0 +1,16 @@
+import { serialize{{Feature}}, serialize{{Feature}}Page } from '../../../Features/{{feature}}/delivery/serializers/{{feature}}.serializer';
+import { {{Feature}} } from '../../../Features/{{feature}}/domain/entity/{{feature}}.entity';
+
+describe('serialize{{Feature}}', () => {
+  const dto = {{sample}};
+  const {{feature}} = new {{Feature}}('123', {{dto_args}});
+
+  it('should produce the same JSON as JSON.stringify', () => {
+    expect(serialize{{Feature}}({{feature}})).toBe(JSON.stringify({{feature}}));
+  });
+
+  it('should serialize a page of {{feature}}', () => {
+    const page = { items: [{{feature}}, {{feature}}], nextCursor: 'abc' };
+    expect(JSON.parse(serialize{{Feature}}Page(page))).toEqual(JSON.parse(JSON.stringify(page)));
+  });
+});
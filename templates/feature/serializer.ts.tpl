@@ -0,0 +1,23 @@
+import { {{Feature}} } from '../../domain/entity/{{feature}}.entity';
+import { {{Feature}}Page } from '../../domain/repositories/{{feature}}.repository.interface';
+import { CustomError } from '../../../../Core/error/custom-error';
+import { Result } from '../../../../Core/result/result';
+
+// Generated from the --fields definitions: keys and types are known up front, so each field is written
+// directly instead of JSON.stringify discovering the object's shape on every response
+export const serialize{{Feature}} = ({{feature}}: {{Feature}}): string =>
+  {{serialize_fields}};
+
+export const serialize{{Feature}}Page = (page: {{Feature}}Page): string =>
+  '{"items":[' + page.items.map(serialize{{Feature}}).join(',') + '],"nextCursor":' + JSON.stringify(page.nextCursor) + '}';
+
+export const serialize{{Feature}}BulkResults = (results: Result<{{Feature}}, CustomError>[], failed: number): string =>
+  '{"inserted":' + (results.length - failed) + ',"failed":' + failed + ',"results":[' +
+  results
+    .map((item) => {
+      if (item.isOk()) return '{"kind":"Ok","value":' + serialize{{Feature}}(item.unwrap()) + '}';
+      const error = item.unwrapErr();
+      return '{"kind":"Err","error":' + JSON.stringify({ statusCode: error.statusCode, message: error.message }) + '}';
+    })
+    .join(',') +
+  ']}';
@@ -0,0 +1,20 @@
+import { injectable, inject } from 'tsyringe';
+import { {{Feature}} } from '../entity/{{feature}}.entity';
+import { {{Feature}}Repository, {{Feature}}Changes } from '../repositories/{{feature}}.repository.interface';
+import { Result, Ok, Err } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';{{metrics_import useCaseDuration}}{{tracing_import}}
+
+export type Update{{Feature}}Dto = {{Feature}}Changes;
+
+@injectable()
+export class Update{{Feature}}UseCase {
+  constructor(@inject('{{Feature}}Repository') private {{feature}}Repository: {{Feature}}Repository) {}
+
+  // Writes only the fields in dto, in a single round trip; with expectedVersion the write applies only to that version
+  {{timed useCaseDuration Update{Feature}UseCase}}{{traced Update{Feature}UseCase.execute}}async execute(id: string, dto: Update{{Feature}}Dto, expectedVersion?: number): Promise<Result<{{Feature}}, CustomError>> {
+    const result = await this.{{feature}}Repository.update(id, dto, expectedVersion);
+    if (result.isErr()) return Err(result.unwrapErr());
+    const {{feature}} = result.unwrap();
+    return {{feature}} ? Ok({{feature}}) : Err(new CustomError(404, '{{feature}} ' + id + ' not found'));
+  }
+}
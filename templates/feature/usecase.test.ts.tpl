@@ -0,0 +1,145 @@
+import { container } from '../../../Features/{{feature}}/container';
+import { Create{{Feature}}UseCase, Create{{Feature}}Dto } from '../../../Features/{{feature}}/domain/usecases/create-{{feature}}.usecase';
+import { CreateMany{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/create-many-{{feature}}.usecase';
+import { List{{Feature}}UseCase, MAX_PAGE_SIZE } from '../../../Features/{{feature}}/domain/usecases/list-{{feature}}.usecase';
+import { Update{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/update-{{feature}}.usecase';
+import { Delete{{Feature}}UseCase } from '../../../Features/{{feature}}/domain/usecases/delete-{{feature}}.usecase';
+import { {{Feature}}Repository } from '../../../Features/{{feature}}/domain/repositories/{{feature}}.repository.interface';
+import { Result, Ok, Err } from '../../../Core/result/result';
+import { CustomError } from '../../../Core/error/custom-error';
+import { {{Feature}} } from '../../../Features/{{feature}}/domain/entity/{{feature}}.entity';
+
+// One repository mock for every use case below, registered fresh before each test
+let mockRepository: jest.Mocked<{{Feature}}Repository>;
+
+const createMockRepository = (): jest.Mocked<{{Feature}}Repository> => ({
+  create: jest.fn(),
+  createMany: jest.fn(),
+  findById: jest.fn(),
+  findPage: jest.fn(),
+  update: jest.fn(),
+  delete: jest.fn(),
+});
+
+beforeEach(() => {
+  mockRepository = createMockRepository();
+  container.registerInstance('{{Feature}}Repository', mockRepository);
+});
+
+afterEach(() => {
+  // Drops the mock and any cached instances but keeps the registrations from container.ts
+  container.clearInstances();
+});
+
+describe('Create{{Feature}}UseCase', () => {
+  let create{{Feature}}UseCase: Create{{Feature}}UseCase;
+
+  beforeEach(() => {
+    create{{Feature}}UseCase = container.resolve<Create{{Feature}}UseCase>('Create{{Feature}}UseCase');
+  });
+
+  it('should create a {{feature}} successfully', async () => {
+    const dto: Create{{Feature}}Dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}});
+    mockRepository.create.mockResolvedValue(Ok({{feature}}));
+
+    const result = await create{{Feature}}UseCase.execute(dto);
+
+    expect(result.isOk()).toBe(true);
+    expect(result.unwrap()).toEqual({{feature}});
+    expect(mockRepository.create).toHaveBeenCalledWith(expect.any({{Feature}}));
+  });
+
+  it('should return an error if repository fails', async () => {
+    const dto: Create{{Feature}}Dto = {{sample}};
+    const error = new CustomError(500, 'Repository error');
+    mockRepository.create.mockResolvedValue(Err(error));
+
+    const result = await create{{Feature}}UseCase.execute(dto);
+
+    expect(result.isErr()).toBe(true);
+    expect(result.unwrapErr()).toEqual(error);
+  });
+
+  it('should follow the {{DI_SCOPE}} DI scope', () => {
+{{scope_assertions}}
+  });
+});
+
+describe('CreateMany{{Feature}}UseCase', () => {
+  let createMany{{Feature}}UseCase: CreateMany{{Feature}}UseCase;
+
+  beforeEach(() => {
+    createMany{{Feature}}UseCase = container.resolve<CreateMany{{Feature}}UseCase>('CreateMany{{Feature}}UseCase');
+  });
+
+  it('should pass every item to the repository in one call and keep per-item results', async () => {
+    const dto: Create{{Feature}}Dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}});
+    const error = new CustomError(409, 'Duplicate');
+    mockRepository.createMany.mockResolvedValue(Ok([Ok({{feature}}), Err(error)]));
+
+    const result = await createMany{{Feature}}UseCase.execute([dto, dto]);
+
+    expect(mockRepository.createMany).toHaveBeenCalledTimes(1);
+    expect(mockRepository.createMany.mock.calls[0][0]).toHaveLength(2);
+    const items = result.unwrap();
+    expect(items[0].unwrap()).toEqual({{feature}});
+    expect(items[1].unwrapErr()).toEqual(error);
+  });
+});
+
+describe('List{{Feature}}UseCase', () => {
+  let list{{Feature}}UseCase: List{{Feature}}UseCase;
+
+  beforeEach(() => {
+    list{{Feature}}UseCase = container.resolve<List{{Feature}}UseCase>('List{{Feature}}UseCase');
+  });
+
+  it('should cap the page size', async () => {
+    mockRepository.findPage.mockResolvedValue(Ok({ items: [], nextCursor: null }));
+
+    await list{{Feature}}UseCase.execute('cursor', 10_000);
+
+    expect(mockRepository.findPage).toHaveBeenCalledWith('cursor', MAX_PAGE_SIZE);
+  });
+});
+
+describe('Update{{Feature}}UseCase and Delete{{Feature}}UseCase', () => {
+  let update{{Feature}}UseCase: Update{{Feature}}UseCase;
+  let delete{{Feature}}UseCase: Delete{{Feature}}UseCase;
+
+  beforeEach(() => {
+    update{{Feature}}UseCase = container.resolve<Update{{Feature}}UseCase>('Update{{Feature}}UseCase');
+    delete{{Feature}}UseCase = container.resolve<Delete{{Feature}}UseCase>('Delete{{Feature}}UseCase');
+  });
+
+  it('should pass only the changed fields and the expected version to the repository', async () => {
+    const dto = {{sample}};
+    const {{feature}} = new {{Feature}}('123', {{dto_args}}, 4);
+    mockRepository.update.mockResolvedValue(Ok({{feature}}));
+
+    const result = await update{{Feature}}UseCase.execute('123', dto, 3);
+
+    expect(result.unwrap()).toEqual({{feature}});
+    expect(mockRepository.update).toHaveBeenCalledWith('123', dto, 3);
+  });
+
+  it('should return 404 when there is nothing to update or delete', async () => {
+    mockRepository.update.mockResolvedValue(Ok(null));
+    mockRepository.delete.mockResolvedValue(Ok(false));
+
+    expect((await update{{Feature}}UseCase.execute('missing', {})).unwrapErr().statusCode).toBe(404);
+    expect((await delete{{Feature}}UseCase.execute('missing')).unwrapErr().statusCode).toBe(404);
+  });
+
+  it('should pass a version conflict through', async () => {
+    const conflict = new CustomError(412, 'Modified');
+    mockRepository.delete.mockResolvedValue(Err(conflict));
+
+    const result = await delete{{Feature}}UseCase.execute('123', 1);
+
+    expect(result.unwrapErr()).toEqual(conflict);
+    expect(mockRepository.delete).toHaveBeenCalledWith('123', 1);
+  });
+});
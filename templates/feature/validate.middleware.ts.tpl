@@ -0,0 +1,22 @@
+import { Request, Response, NextFunction } from 'express';
+import { Err } from '../../../../Core/result/result';
+import { CustomError } from '../../../../Core/error/custom-error';
+import { {{validator_import}} } from './{{feature}}.validator';
+
+// Failures are handed to next() as Err results instead of being thrown; Core/error/error-handler renders them
+export const validate{{Feature}} = (req: Request, res: Response, next: NextFunction) => {
+  {{validate_single}}
+};
+
+// PATCH bodies: any subset of the fields, but at least one, and nothing that is not a field
+export const validate{{Feature}}Patch = (req: Request, res: Response, next: NextFunction) => {
+  {{validate_patch}}
+};
+
+export const validate{{Feature}}Bulk = (req: Request, res: Response, next: NextFunction) => {
+  const maxItems = Number(process.env.BULK_MAX_ITEMS) || 10000;
+  if (Array.isArray(req.body) && req.body.length > maxItems) {
+    return next(Err(new CustomError(413, 'Bulk requests are limited to ' + maxItems + ' items')));
+  }
+  {{validate_bulk}}
+};
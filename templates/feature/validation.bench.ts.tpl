@@ -0,0 +1,31 @@
+// Compares the Zod schema with the inline validator generated for {{feature}} (tsclean feature {{feature}} --validator inline).
+// Run with: npx ts-node bench/{{feature}}.validation.bench.ts
+import { {{feature}}Schema, format{{Feature}}Issues, check{{Feature}} } from '../Features/{{feature}}/delivery/middlewares/{{feature}}.validator';
+
+const ITERATIONS = Number(process.env.BENCH_ITERATIONS || 1_000_000);
+
+const payloads: Record<string, unknown> = {
+  valid: {{valid_payload}},
+  invalid: {},
+};
+
+const validators: Record<string, (body: unknown) => string | null> = {
+  zod: (body) => {
+    const result = {{feature}}Schema.safeParse(body);
+    return result.success ? null : format{{Feature}}Issues(result.error.issues);
+  },
+  inline: check{{Feature}},
+};
+
+for (const [kind, body] of Object.entries(payloads)) {
+  for (const [name, validate] of Object.entries(validators)) {
+    let failures = 0;
+    for (let i = 0; i < 10_000; i++) validate(body); // warm-up
+    const start = process.hrtime.bigint();
+    for (let i = 0; i < ITERATIONS; i++) {
+      if (validate(body) !== null) failures++;
+    }
+    const elapsed = Number(process.hrtime.bigint() - start);
+    console.log((name + ' ' + kind).padEnd(16), (elapsed / ITERATIONS).toFixed(1).padStart(8), 'ns/op', '(' + failures + ' failures)');
+  }
+}
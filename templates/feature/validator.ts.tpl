@@ -0,0 +1,46 @@
+import { z } from 'zod';
+{{email_pattern}}
+export const {{feature}}Schema = {{zod_schema}};
+export const {{feature}}BulkSchema = z.array({{feature}}Schema).min(1);
+// PATCH bodies: every field optional, but at least one, and unknown keys are rejected so $set only touches fields
+export const {{feature}}PatchSchema = {{feature}}Schema
+  .partial()
+  .strict()
+  .refine((body) => Object.keys(body).length > 0, { message: 'body must set at least one field' });
+
+// Zod issues worded like check{{Feature}}, so both validators report the same messages
+export const format{{Feature}}Issues = (issues: z.ZodIssue[]): string =>
+  issues
+    .map((issue) => {
+      const path = issue.path.join('.');
+      if (issue.code === 'unrecognized_keys') return issue.keys.join(', ') + ' is not a field of {{feature}}';
+      if (issue.code === 'invalid_type' && issue.received === 'undefined') return path + ' is required';
+      return path ? path + ': ' + issue.message : issue.message;
+    })
+    .join(', ');
+
+// Hand-specialized from the --fields rules: checks each field inline with no schema interpretation at runtime
+// eslint-disable-next-line @typescript-eslint/no-explicit-any
+export const check{{Feature}} = (body: any): string | null => {
+  if (typeof body !== 'object' || body === null || Array.isArray(body)) return 'body must be an object';{{inline_checks}}
+  return null;
+};
+
+const {{feature}}Fields = new Set([{{patch_fields}}]);
+
+// The PATCH counterpart of check{{Feature}}: fields are optional, but present ones get the same checks
+// eslint-disable-next-line @typescript-eslint/no-explicit-any
+export const check{{Feature}}Patch = (body: any): string | null => {
+  if (typeof body !== 'object' || body === null || Array.isArray(body)) return 'body must be an object';
+  const keys = Object.keys(body);
+  if (keys.length === 0) return 'body must set at least one field';
+  for (const key of keys) {
+    if (!{{feature}}Fields.has(key)) return key + ' is not a field of {{feature}}';
+  }{{inline_patch_checks}}
+  return null;
+};
+
+// One record at a time, for the NDJSON import where records are validated as they stream in
+export const validate{{Feature}}Record = (body: unknown): string | null => {
+{{validate_record}}
+};
@@ -0,0 +1,24 @@
+import { workerPool } from '../../../Core/workers/pool';
+import { prepare{{Feature}}, prepare{{Feature}}Task, prepare{{Feature}}ListTask } from '../../../Features/{{feature}}/domain/workers/{{feature}}.task';
+
+describe('{{feature}} worker tasks', () => {
+  const dto = {{sample}};
+
+  it('should run prepare{{Feature}} on a worker thread', async () => {
+    const result = await workerPool().run(prepare{{Feature}}Task, dto);
+
+    expect(result.unwrap()).toEqual(prepare{{Feature}}(dto));
+  });
+
+  it('should prepare a whole batch in one job', async () => {
+    const result = await workerPool().run(prepare{{Feature}}ListTask, [dto, dto]);
+
+    expect(result.unwrap()).toEqual([dto, dto]);
+  });
+
+  it('should turn a task that cannot run into an Err', async () => {
+    const result = await workerPool().run({ ...prepare{{Feature}}Task, name: 'missing' }, dto);
+
+    expect(result.unwrapErr().statusCode).toBe(500);
+  });
+});
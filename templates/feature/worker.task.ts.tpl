@@ -0,0 +1,14 @@
+import type { Create{{Feature}}Dto } from '../usecases/create-{{feature}}.usecase';
+
+// Runs on a Core/workers thread, off the event loop: Create{{Feature}}UseCase and CreateMany{{Feature}}UseCase pass their
+// input through here before building entities, so CPU-heavy steps (hashing, report building, metadata extraction)
+// belong in prepare{{Feature}}. Payloads are structured-cloned both ways; return transfer(value, [buffer]) from
+// Core/workers/pool to move ArrayBuffers back instead.
+export const prepare{{Feature}} = (dto: Create{{Feature}}Dto): Create{{Feature}}Dto => dto;
+
+// The whole batch in one job, so a bulk request pays for one round trip to the thread rather than one per item
+export const prepare{{Feature}}List = (dtos: Create{{Feature}}Dto[]): Create{{Feature}}Dto[] => dtos.map(prepare{{Feature}});
+
+// What the use cases pass to workerPool().run: the thread loads the function by name from this file
+export const prepare{{Feature}}Task = { file: __filename, name: 'prepare{{Feature}}' };
+export const prepare{{Feature}}ListTask = { file: __filename, name: 'prepare{{Feature}}List' };
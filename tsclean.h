@@ -1,40 +1,126 @@
 #!/bin/bash
 
 # Bash script to set up a TypeScript Express API with MongoDB, Mongoose, clean architecture, Zod validation, tsyringe DI, and Jest testing
-# Usage: tsclean <project-name> [path] [--feature <feature-name> --fields <field1:type1:rule1,field2:type2:rule2> ...]
-#        tsclean feature <feature-name> [--fields <field1:type1:rule1,field2:type2:rule2>]
+# Usage: tsclean <project-name> [path] [--result closure|class] [--di-scope singleton|transient|request] [--cluster | --workers <n>] [--perf] [--http express|fastify] [--metrics] [--tracing] [--protect] [--build tsc|esbuild] [--target server|lambda] [--timings] [--install npm|skip|offline|pnpm] [--feature <feature-name> --fields <field1:type1:rule1,field2:type2:rule2> [--indexes <field1+field2>] [--page-by <field>] [--lean-reads] [--replica-reads] [--validator zod|inline] [--id-field id|_id] [--cache memory|redis] [--offload none|worker] [--outbox] [--kind crud|readmodel --source <feature>] ...]
+#        tsclean apply [tsclean.yaml] [--jobs <n>] [--force] [--timings] [--install npm|skip|offline|pnpm]
+#        tsclean feature <feature-name> [--fields <field1:type1:rule1,field2:type2:rule2>] [--indexes <field1+field2>] [--page-by <field>] [--lean-reads] [--replica-reads] [--validator zod|inline] [--id-field id|_id] [--cache memory|redis] [--offload none|worker] [--outbox] [--kind crud|readmodel --source <feature>] [--timings] [--install npm|skip|offline|pnpm]
 # Example: tsclean FoodStore ./ --feature products --fields name:string:minlength=3,price:number:min=0
-#          tsclean feature payment --fields amount:number:min=0,method:string:enum=credit|debit
+#          tsclean feature payment --fields amount:number:min=0,method:string:enum=credit|debit:index --indexes method+-amount
 
 DEFAULT_PROJECT_NAME="my-express-api"
 PROJECT_NAME="$DEFAULT_PROJECT_NAME"
 PATH_SPECIFIED="."
 FEATURES=()
 FIELD_DEFS=()
+INDEX_DEFS=()
+PAGE_KEYS=()
+LEAN_READS=()
+REPLICA_READS=()
+VALIDATORS=()
+ID_FIELDS=()
+CACHES=()
+OFFLOADS=()
+OUTBOXES=()
+KINDS=()
+SOURCES=()
 NODE_VERSION="18"
+RESULT_STYLE="closure"
+DI_SCOPE="singleton"
+CLUSTER="false"
+WORKERS=0
+PERF="false"
+HTTP_FRAMEWORK="express"
+METRICS="false"
+TRACING="false"
+PROTECT="false"
+BUILD="tsc"
+TARGET="server"
+TIMINGS="false"
+INSTALL_MODE="npm"
+GENERATE_JOBS=1
+REGENERATE=()
+SCRIPT_DIR="${BASH_SOURCE[0]%/*}"
+[ "$SCRIPT_DIR" = "${BASH_SOURCE[0]}" ] && SCRIPT_DIR="."
+[[ "$SCRIPT_DIR" = /* ]] || SCRIPT_DIR="$PWD/$SCRIPT_DIR"
+# Lockfile templates ship in lockfiles/ next to this script; TSCLEAN_LOCKFILE_DIR points elsewhere (e.g. a CI cache)
+LOCKFILE_DIR="${TSCLEAN_LOCKFILE_DIR:-$SCRIPT_DIR/lockfiles}"
+# File templates ship in templates/ next to this script, shared with tsclean.ps1; TSCLEAN_TEMPLATE_DIR overrides it
+TEMPLATE_DIR="${TSCLEAN_TEMPLATE_DIR:-$SCRIPT_DIR/templates}"
+
+# Function to read a microsecond clock into the variable named $1 (EPOCHREALTIME needs no fork on bash 5+)
+phase_clock() {
+    if [ -n "$EPOCHREALTIME" ]; then
+        printf -v "$1" '%s' "${EPOCHREALTIME//[.,]/}"
+    else
+        printf -v "$1" '%s' "$(($(date +%s) * 1000000))"
+    fi
+}
+
+# Function to record how long the phase that just finished took, reported at the end with --timings
+PHASE_NAMES=()
+PHASE_MICROS=()
+phase_done() {
+    [ "$TIMINGS" = "true" ] || return 0
+    local now
+    phase_clock now
+    PHASE_NAMES+=("$1")
+    PHASE_MICROS+=($((now - PHASE_STARTED)))
+    PHASE_STARTED=$now
+}
+phase_clock PHASE_STARTED
+
+# Function to store $2 with its first letter capitalized in the variable named $1, without forking tr
+LOWER_LETTERS="abcdefghijklmnopqrstuvwxyz"
+UPPER_LETTERS="ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+capitalize_into() {
+    local first="${2:0:1}"
+    local before="${LOWER_LETTERS%%"$first"*}"
+    [ -n "$first" ] && [ "${#before}" -lt 26 ] && first="${UPPER_LETTERS:${#before}:1}"
+    printf -v "$1" '%s%s' "$first" "${2:1}"
+}
 
 # Function to capitalize first letter
 capitalize() {
-    echo "$(tr '[:lower:]' '[:upper:]' <<< ${1:0:1})${1:1}"
+    local word
+    capitalize_into word "$1"
+    echo "$word"
 }
 
-# Function to convert type to TypeScript type
+# Function to store the TypeScript type for --fields type $2 in the variable named $1
 to_ts_type() {
-    case "$1" in
-        string) echo "string" ;;
-        number) echo "number" ;;
-        boolean) echo "boolean" ;;
-        *) echo "any" ;;
+    case "$2" in
+        string|number|boolean) printf -v "$1" '%s' "$2" ;;
+        *) printf -v "$1" '%s' "any" ;;
     esac
 }
 
-# Function to convert type to Mongoose type
+# Function to store the Mongoose type for --fields type $2 in the variable named $1
 to_mongoose_type() {
-    case "$1" in
-        string) echo "String" ;;
-        number) echo "Number" ;;
-        boolean) echo "Boolean" ;;
-        *) echo "Mixed" ;;
+    case "$2" in
+        string) printf -v "$1" '%s' "String" ;;
+        number) printf -v "$1" '%s' "Number" ;;
+        boolean) printf -v "$1" '%s' "Boolean" ;;
+        *) printf -v "$1" '%s' "Mixed" ;;
+    esac
+}
+
+# Function to store in the variable named $1 the --fields type of field $3 of CRUD feature $2: from its --fields in
+# this run, or else from its Mongoose model (any type other than string, number or boolean comes back as "mixed")
+source_field_type() {
+    local j definition
+    for j in "${!FEATURES[@]}"; do
+        if [ "${FEATURES[$j]}" = "$2" ] && [ "${KINDS[$j]}" = "crud" ]; then
+            definition=",${FIELD_DEFS[$j]:-name:string:minlength=3,email:string:email},"
+            definition="${definition#*,$3:}"
+            printf -v "$1" '%s' "${definition%%[:,]*}"
+            return 0
+        fi
+    done
+    case "$(sed -n "s/^  $3: { type: \([A-Za-z.]*\).*/\1/p" "Features/$2/data/models/$2.model.ts")" in
+        String) printf -v "$1" '%s' "string" ;;
+        Number) printf -v "$1" '%s' "number" ;;
+        Boolean) printf -v "$1" '%s' "boolean" ;;
+        *) printf -v "$1" '%s' "mixed" ;;
     esac
 }
 
@@ -53,11 +139,12 @@ parse_fields() {
     done
 }
 
-# Function to generate Zod validation schema
+# Function to build the Zod validation schema for the fields into zod_schema
 get_zod_schema() {
     local field_names=("${!1}")
     local field_types=("${!2}")
     local field_rules=("${!3}")
+    local i name type rule zod_type rules enums enum_values enum_str
     zod_schema="z.object({"
     for i in "${!field_names[@]}"; do
         name="${field_names[$i]}"
@@ -69,7 +156,8 @@ get_zod_schema() {
             boolean) zod_type="z.boolean()" ;;
             *) zod_type="z.any()" ;;
         esac
-        if [ -n "$rule" ]; then
+        IFS=':' read -ra rules <<< "$rule"
+        for rule in "${rules[@]}"; do
             case "$rule" in
                 email) zod_type="$zod_type.email()" ;;
                 minlength=*) zod_type="$zod_type.min(${rule#minlength=})" ;;
@@ -79,21 +167,563 @@ get_zod_schema() {
                 enum=*) 
                     enums="${rule#enum=}"
                     IFS='|' read -ra enum_values <<< "$enums"
-                    enum_str=$(printf "\"%s\"," "${enum_values[@]}" | sed 's/,$//')
+                    printf -v enum_str '"%s",' "${enum_values[@]}"
+                    enum_str="${enum_str%,}"
                     zod_type="z.enum([$enum_str])"
                     ;;
+                index|unique|text) ;; # Storage rules, emitted as Schema.index() calls by get_schema_indexes
+            esac
+        done
+        zod_schema+=$'\n'"    $name: $zod_type,"
+    done
+    zod_schema+=$'\n'"})"
+}
+
+# Function to generate hand-specialized validators from the field rules (same checks as get_zod_schema, no runtime schema):
+# inline_checks for a whole record, inline_patch_checks for a PATCH body, which only checks the fields it carries
+get_inline_validator() {
+    local i rule rules name type enums enum_values enum_value enum_checks field_checks
+    inline_checks=""
+    inline_patch_checks=""
+    patch_fields=""
+    inline_needs_email="false"
+    for i in "${!field_names[@]}"; do
+        name="${field_names[$i]}"
+        type="${field_types[$i]}"
+        patch_fields+="'$name', "
+        case "$type" in
+            string|number|boolean) ;;
+            *) continue ;; # z.any() accepts any value, including a missing one
+        esac
+        field_checks="
+  if (typeof body.$name !== '$type') return '$name must be a $type';"
+        IFS=':' read -ra rules <<< "${field_rules[$i]}"
+        for rule in "${rules[@]}"; do
+            case "$rule" in
+                email)
+                    inline_needs_email="true"
+                    field_checks+="
+  if (!EMAIL_PATTERN.test(body.$name)) return '$name must be a valid email';"
+                    ;;
+                minlength=*|min=*)
+                    if [ "$type" = "string" ]; then
+                        field_checks+="
+  if (body.$name.length < ${rule#*=}) return '$name must be at least ${rule#*=} characters';"
+                    else
+                        field_checks+="
+  if (body.$name < ${rule#*=}) return '$name must be at least ${rule#*=}';"
+                    fi
+                    ;;
+                maxlength=*|max=*)
+                    if [ "$type" = "string" ]; then
+                        field_checks+="
+  if (body.$name.length > ${rule#*=}) return '$name must be at most ${rule#*=} characters';"
+                    else
+                        field_checks+="
+  if (body.$name > ${rule#*=}) return '$name must be at most ${rule#*=}';"
+                    fi
+                    ;;
+                enum=*)
+                    enums="${rule#enum=}"
+                    IFS='|' read -ra enum_values <<< "$enums"
+                    enum_checks=""
+                    for enum_value in "${enum_values[@]}"; do
+                        enum_checks+="body.$name !== '$enum_value' && "
+                    done
+                    enum_checks="${enum_checks% && }"
+                    field_checks+="
+  if ($enum_checks) return '$name must be one of ${enums//|/, }';"
+                    ;;
+            esac
+        done
+        inline_checks+="
+  if (body.$name === undefined) return '$name is required';$field_checks"
+        # PATCH bodies may leave any field out, so the same checks only run for the fields that are present
+        inline_patch_checks+="
+  if (body.$name !== undefined) {${field_checks//$'\n'/$'\n'  }
+  }"
+    done
+    patch_fields="${patch_fields%, }"
+}
+
+# Function to generate Schema.index() calls from field rules and compound --indexes declarations
+get_schema_indexes() {
+    local schema="$1"
+    local compound="$2"
+    local text_keys=""
+    local i rule rules compound_index compound_indexes index_field index_fields
+    schema_indexes=""
+    for i in "${!field_names[@]}"; do
+        IFS=':' read -ra rules <<< "${field_rules[$i]}"
+        for rule in "${rules[@]}"; do
+            case "$rule" in
+                index) schema_indexes+=$'\n'"$schema.index({ ${field_names[$i]}: 1 });" ;;
+                unique) schema_indexes+=$'\n'"$schema.index({ ${field_names[$i]}: 1 }, { unique: true });" ;;
+                text) text_keys+="${field_names[$i]}: 'text', " ;;
+            esac
+        done
+    done
+    # MongoDB allows a single text index per collection, so all text fields share one
+    if [ -n "$text_keys" ]; then
+        schema_indexes+=$'\n'"$schema.index({ ${text_keys%, } });"
+    fi
+    IFS=',' read -ra compound_indexes <<< "$compound"
+    for compound_index in "${compound_indexes[@]}"; do
+        local keys=""
+        IFS='+' read -ra index_fields <<< "$compound_index"
+        for index_field in "${index_fields[@]}"; do
+            local direction=1
+            if [[ "$index_field" == -* ]]; then
+                direction=-1
+                index_field="${index_field#-}"
+            fi
+            if [ "$index_field" != "id" ] && [[ " ${field_names[*]} " != *" $index_field "* ]]; then
+                echo "Error: --indexes references unknown field '$index_field'"
+                exit 1
+            fi
+            keys+="$index_field: $direction, "
+        done
+        schema_indexes+=$'\n'"$schema.index({ ${keys%, } });"
+    done
+    if [ -n "$schema_indexes" ]; then
+        schema_indexes+=$'\n'
+    fi
+}
+
+# Function to build "json_properties" and "json_required" (JSON Schema, for Fastify) from the parsed --fields
+get_json_schema() {
+    local j name rule rules keywords enum_values
+    json_properties=""
+    json_required=""
+    for j in "${!field_names[@]}"; do
+        name="${field_names[$j]}"
+        case "${field_types[$j]}" in
+            string|number|boolean) keywords="type: '${field_types[$j]}'" ;;
+            *) keywords="" ;;
+        esac
+        IFS=':' read -ra rules <<< "${field_rules[$j]}"
+        for rule in "${rules[@]}"; do
+            case "$rule" in
+                email) keywords+=", format: 'email'" ;;
+                minlength=*) keywords+=", minLength: ${rule#minlength=}" ;;
+                maxlength=*) keywords+=", maxLength: ${rule#maxlength=}" ;;
+                min=*) keywords+=", minimum: ${rule#min=}" ;;
+                max=*) keywords+=", maximum: ${rule#max=}" ;;
+                enum=*)
+                    IFS='|' read -ra enum_values <<< "${rule#enum=}"
+                    printf -v enum_list "'%s', " "${enum_values[@]}"
+                    keywords+=", enum: [${enum_list%, }]"
+                    ;;
             esac
+        done
+        json_properties+=$'\n'"  $name: { ${keywords#, } },"
+        # Like z.any(), untyped fields may be omitted
+        case "${field_types[$j]}" in
+            string|number|boolean) json_required+="'$name', " ;;
+        esac
+    done
+    json_properties="${json_properties//\{  \}/\{\}}"
+    json_required="${json_required%, }"
+}
+
+# Function to build "sample_json": one example value per parsed field (without the surrounding braces),
+# used by the generated tests, benches and load scenarios and by README.md
+get_sample_json() {
+    local j name type rule enum_value
+    sample_json=""
+    for j in "${!field_names[@]}"; do
+        name="${field_names[$j]}"
+        type="${field_types[$j]}"
+        rule="${field_rules[$j]}"
+        case "$type" in
+            string)
+                if [[ ":$rule:" == *":email:"* ]]; then
+                    sample_json+="\"$name\": \"test@example.com\", "
+                elif [[ ":$rule" =~ :enum=([^:|]*) ]]; then
+                    enum_value="${BASH_REMATCH[1]}"
+                    sample_json+="\"$name\": \"$enum_value\", "
+                else
+                    sample_json+="\"$name\": \"sample_${name}\", "
+                fi
+                ;;
+            number) sample_json+="\"$name\": 123, " ;;
+            boolean) sample_json+="\"$name\": true, " ;;
+            *) sample_json+="\"$name\": null, " ;;
+        esac
+    done
+    sample_json="${sample_json%, }"
+}
+
+# Function to build "serialize_fields": one string concatenation per field, encoded by its --fields type
+get_serializer() {
+    local j name
+    serialize_fields="'{\"id\":' + JSON.stringify(${feature}.id)"
+    for j in "${!field_names[@]}"; do
+        name="${field_names[$j]}"
+        case "${field_types[$j]}" in
+            boolean) serialize_fields+=" + ',\"$name\":' + (${feature}.$name ? 'true' : 'false')" ;;
+            number) serialize_fields+=" + ',\"$name\":' + (Number.isFinite(${feature}.$name) ? String(${feature}.$name) : 'null')" ;;
+            string) serialize_fields+=" + ',\"$name\":' + JSON.stringify(${feature}.$name)" ;;
+            *) serialize_fields+=" + ',\"$name\":' + (JSON.stringify(${feature}.$name) ?? 'null')" ;;
+        esac
+    done
+    serialize_fields+=" + ',\"version\":' + ${feature}.version + '}'"
+}
+
+# Template helpers: each sets REPLY, and templates call them as {{helper arg ...}} (see render_template)
+
+# Function to set REPLY to a tsyringe registration for the project's --di-scope
+# singleton: one instance per process; transient: a new instance per resolve;
+# request: one instance per child container, which Server/index.ts creates per HTTP request
+di_register() {
+    local token="$1"
+    local class="$2"
+    case "$DI_SCOPE" in
+        singleton) REPLY="container.registerSingleton<$class>($token, $class);" ;;
+        transient) REPLY="container.register<$class>($token, { useClass: $class });" ;;
+        request) REPLY="container.register<$class>($token, { useClass: $class }, { lifecycle: Lifecycle.ContainerScoped });" ;;
+    esac
+}
+
+# Function to set REPLY to a @timed(...) decorator for the method that follows it (nothing without --metrics)
+timed() {
+    REPLY=""
+    [ "$METRICS" = "true" ] && printf -v REPLY "@timed(%s, '%s')\n  " "$1" "$2"
+    return 0
+}
+
+# Function to set REPLY to the Core/metrics import for a feature file that uses timed() (nothing without --metrics)
+metrics_import() {
+    REPLY=""
+    [ "$METRICS" = "true" ] && printf -v REPLY "\nimport { timed, %s } from '../../../../Core/metrics/metrics';" "$1"
+    return 0
+}
+
+# Function to set REPLY to a @traced(...) decorator opening a span around the method that follows it (nothing without --tracing)
+traced() {
+    REPLY=""
+    [ "$TRACING" = "true" ] && printf -v REPLY "@traced('%s')\n  " "$1"
+    return 0
+}
+
+# Function to set REPLY to the Core/tracing import for a feature file that uses traced() (nothing without --tracing)
+tracing_import() {
+    REPLY=""
+    [ "$TRACING" = "true" ] && printf -v REPLY "\nimport { traced } from '../../../../Core/tracing/traced';"
+    return 0
+}
+
+# Function to set REPLY to the Core/middleware import for a controller that uses rate_limited() (nothing without --protect)
+protect_import() {
+    REPLY=""
+    [ "$PROTECT" = "true" ] && printf -v REPLY "\nimport { rateLimit, shedLoad } from '../../../../Core/middleware/overload';"
+    return 0
+}
+
+# Function to set REPLY to the statement that puts a controller's routes behind the load shedder (nothing without --protect)
+shed_load() {
+    REPLY=""
+    if [ "$PROTECT" = "true" ]; then
+        case "$HTTP_FRAMEWORK" in
+            fastify) REPLY=$'\n'"    app.addHook('onRequest', shedLoad);" ;;
+            *) REPLY=$'\n'"    this.router.use(shedLoad);" ;;
+        esac
+    fi
+    return 0
+}
+
+# Function to set REPLY to the rate limiter of route $1, as an Express middleware argument or a Fastify route option
+# (nothing without --protect)
+rate_limited() {
+    REPLY=""
+    if [ "$PROTECT" = "true" ]; then
+        case "$HTTP_FRAMEWORK" in
+            fastify) REPLY="onRequest: rateLimit('$1'), " ;;
+            *) REPLY="rateLimit('$1'), " ;;
+        esac
+    fi
+    return 0
+}
+
+# Function to compile every templates/feature/*.tpl once into TEMPLATE_PARTS, an array alternating literal text with
+# placeholders; TEMPLATES maps each template name to "<first part> <part count>". Placeholders are {{name}}, the
+# value of the variable name, and {{helper arg ...}}, a call to one of the helpers above in which {name} inside an
+# argument is that variable's value.
+declare -A TEMPLATES
+TEMPLATE_PARTS=()
+load_templates() {
+    local file key text literal name
+    for file in "$TEMPLATE_DIR"/feature/*.tpl; do
+        if [ ! -f "$file" ]; then
+            echo "Error: no templates found in $TEMPLATE_DIR"
+            exit 1
         fi
-        zod_schema="$zod_schema\n    $name: $zod_type,"
+        key="${file##*/}"
+        key="${key%.tpl}"
+        IFS= read -r -d '' text < "$file"
+        TEMPLATES[$key]="${#TEMPLATE_PARTS[@]}"
+        literal=""
+        while [[ "$text" == *"{{"* ]]; do
+            literal+="${text%%"{{"*}"
+            text="${text#*"{{"}"
+            # A literal brace right before a placeholder, as in {{{name}}}
+            while [ "${text:0:1}" = "{" ]; do
+                literal+="{"
+                text="${text:1}"
+            done
+            name="${text%%"}}"*}"
+            text="${text#*"}}"}"
+            # Helper arguments may end in {name}, so the placeholder closes at the last brace of the run
+            if [[ "$name" == *" "* ]]; then
+                while [ "${text:0:1}" = "}" ]; do
+                    name+="}"
+                    text="${text:1}"
+                done
+            fi
+            TEMPLATE_PARTS+=("$literal" "$name")
+            literal=""
+        done
+        TEMPLATE_PARTS+=("$literal$text" "")
+        TEMPLATES[$key]+=" $((${#TEMPLATE_PARTS[@]} - ${TEMPLATES[$key]}))"
+    done
+}
+
+# Function to render template $2 into file $1 from the current feature model (the variables set by generate_feature)
+render_template() {
+    local range="${TEMPLATES[$2]}" out="" k end part word arg ref
+    local -a words
+    k="${range% *}"
+    end=$((k + ${range#* }))
+    for ((; k < end; k += 2)); do
+        out+="${TEMPLATE_PARTS[k]}"
+        part="${TEMPLATE_PARTS[k + 1]}"
+        case "${part%% *}" in
+            "") ;;
+            di_register|timed|traced|metrics_import|tracing_import|protect_import|shed_load|rate_limited)
+                IFS=' ' read -ra words <<< "$part"
+                for word in "${!words[@]}"; do
+                    arg="${words[$word]}"
+                    while [[ "$arg" =~ \{([A-Za-z_][A-Za-z0-9_]*)\} ]]; do
+                        ref="${BASH_REMATCH[1]}"
+                        arg="${arg//"{$ref}"/"${!ref}"}"
+                    done
+                    words[$word]="$arg"
+                done
+                "${words[@]}"
+                out+="$REPLY"
+                ;;
+            *)
+                if [[ "$part" == *" "* ]]; then
+                    echo "Error: template $2 calls unknown helper '${part%% *}'"
+                    exit 1
+                fi
+                out+="${!part}"
+                ;;
+        esac
     done
-    zod_schema="$zod_schema\n})"
-    echo -e "$zod_schema"
+    printf '%s' "$out" > "$1"
+}
+
+# Function to install a new project's dependencies according to --install
+# npm: npm install; offline: npm ci --prefer-offline from a matching lockfile template, else npm install --prefer-offline;
+# pnpm: pnpm install from the hard-linked store, frozen to a matching template when there is one; skip: install nothing.
+# Templates are keyed by a checksum of the dependency list, and offline/pnpm runs save the lockfile they produce as the
+# template for that key, so the next project with the same options resolves nothing.
+install_dependencies() {
+    local lock_key lockfile template
+    if [ "$INSTALL_MODE" = "skip" ]; then
+        echo "Skipped installing dependencies (--install skip); run npm install before building"
+        return 0
+    fi
+    read -r lock_key _ < <(printf '%s\n' "${dependencies[@]}" "${dev_dependencies[@]}" | LC_ALL=C sort | cksum)
+    if [ "$INSTALL_MODE" = "pnpm" ]; then
+        lockfile="pnpm-lock.yaml"
+        template="$LOCKFILE_DIR/pnpm-lock.$lock_key.yaml"
+    else
+        lockfile="package-lock.json"
+        template="$LOCKFILE_DIR/package-lock.$lock_key.json"
+    fi
+    echo "Installing dependencies..."
+    if [ -f "$template" ]; then
+        sed "s/__PROJECT_NAME__/$PROJECT_NAME/g" "$template" > "$lockfile"
+        echo "Using lockfile template ${template##*/}"
+    fi
+    case "$INSTALL_MODE" in
+        pnpm)
+            if [ -f "$lockfile" ]; then
+                pnpm install --prefer-offline --frozen-lockfile > /dev/null 2>&1
+            else
+                pnpm install --prefer-offline > /dev/null 2>&1
+            fi
+            ;;
+        offline)
+            if [ -f "$lockfile" ]; then
+                npm ci --prefer-offline --no-audit --no-fund > /dev/null 2>&1
+            else
+                npm install --prefer-offline --no-audit --no-fund > /dev/null 2>&1
+            fi
+            ;;
+        *) npm install > /dev/null 2>&1 ;;
+    esac || {
+        echo "Error: dependency install failed (--install $INSTALL_MODE)"
+        exit 1
+    }
+    echo "Dependencies installed"
+    if [ "$INSTALL_MODE" != "npm" ] && [ ! -f "$template" ] && [ -f "$lockfile" ] && mkdir -p "$LOCKFILE_DIR" 2> /dev/null; then
+        sed "s/\"$PROJECT_NAME\"/\"__PROJECT_NAME__\"/g" "$lockfile" > "$template" 2> /dev/null && echo "Saved lockfile template ${template##*/}"
+    fi
+    return 0
+}
+
+# Function to add packages ("name@range") to an existing project according to --install; $1 is --save or --save-dev.
+# With --install skip the ranges are only written to package.json
+add_packages() {
+    local save="$1" package section
+    shift
+    case "$INSTALL_MODE" in
+        skip)
+            section="dependencies"
+            [ "$save" = "--save-dev" ] && section="devDependencies"
+            for package in "$@"; do
+                npm pkg set "$section.${package%@*}=${package##*@}" > /dev/null 2>&1
+            done
+            echo "Added $* to package.json (--install skip)"
+            return 0
+            ;;
+        pnpm)
+            [ "$save" = "--save" ] && save="--save-prod"
+            pnpm add "$save" --prefer-offline "$@" > /dev/null 2>&1
+            ;;
+        offline) npm install "$save" --prefer-offline --no-audit --no-fund "$@" > /dev/null 2>&1 ;;
+        *) npm install "$save" "$@" > /dev/null 2>&1 ;;
+    esac
+    echo "Installed $*"
+}
+
+# Function to read project-wide settings recorded in .tsclean when the project was created
+load_project_settings() {
+    local key value
+    [ -f .tsclean ] || return 0
+    while IFS='=' read -r key value; do
+        case "$key" in
+            RESULT_STYLE) RESULT_STYLE="$value" ;;
+            DI_SCOPE) DI_SCOPE="$value" ;;
+            CLUSTER) CLUSTER="$value" ;;
+            WORKERS) WORKERS="$value" ;;
+            PERF) PERF="$value" ;;
+            HTTP_FRAMEWORK) HTTP_FRAMEWORK="$value" ;;
+            METRICS) METRICS="$value" ;;
+            TRACING) TRACING="$value" ;;
+            PROTECT) PROTECT="$value" ;;
+            BUILD) BUILD="$value" ;;
+            TARGET) TARGET="$value" ;;
+            INSTALL_MODE) INSTALL_MODE="$value" ;;
+        esac
+    done < .tsclean
+}
+
+# Function to turn a tsclean.yaml manifest into the equivalent --feature flags, collected in "manifest_args".
+# Supports the subset the manifest needs: a top-level "features:" map of feature names, each holding feature
+# options named after their flags (fields, indexes, page-by, lean-reads, replica-reads, validator, id-field, cache,
+# offload, outbox, kind, source) as a scalar or as a "- item" list, which is joined with commas. Comments and blank lines are ignored.
+read_manifest() {
+    local file="$1" line value key lineno=0 feature_indent="" indent list_key="" list_value=""
+    manifest_args=()
+    if [ ! -f "$file" ]; then
+        echo "Error: manifest $file not found"
+        return 1
+    fi
+    while IFS= read -r line || [ -n "$line" ]; do
+        lineno=$((lineno + 1))
+        line="${line%$'\r'}"
+        [[ "$line" =~ ^[[:space:]]*(#|$) ]] && continue
+        [[ "$line" =~ ^(.*[^[:space:]])[[:space:]]+#.*$ ]] && line="${BASH_REMATCH[1]}"
+        value="${line#"${line%%[! ]*}"}"
+        indent=$((${#line} - ${#value}))
+        if [ -n "$list_key" ] && [[ "$value" == "- "* ]]; then
+            value="${value#- }"
+            value="${value#[\"\']}"
+            list_value+=",${value%[\"\']}"
+            continue
+        fi
+        if [ -n "$list_key" ]; then
+            manifest_option "$list_key" "${list_value#,}" || return 1
+            list_key=""
+        fi
+        if [ "$indent" -eq 0 ]; then
+            if [ "$value" != "features:" ]; then
+                echo "Error: $file:$lineno: expected 'features:' at the top level"
+                return 1
+            fi
+        elif [ -z "$feature_indent" ] || [ "$indent" -eq "$feature_indent" ]; then
+            feature_indent="$indent"
+            if ! [[ "$value" =~ ^([A-Za-z][A-Za-z0-9_]*):$ ]]; then
+                echo "Error: $file:$lineno: expected a feature name followed by ':'"
+                return 1
+            fi
+            manifest_args+=(--feature "${BASH_REMATCH[1]}")
+        elif [[ "$value" =~ ^([a-z-]+):[[:space:]]*(.*)$ ]]; then
+            key="${BASH_REMATCH[1]}"
+            value="${BASH_REMATCH[2]}"
+            value="${value#[\"\']}"
+            value="${value%[\"\']}"
+            if [ -z "$value" ]; then
+                list_key="$key"
+                list_value=""
+            else
+                manifest_option "$key" "$value" || return 1
+            fi
+        else
+            echo "Error: $file:$lineno: expected 'option: value'"
+            return 1
+        fi
+    done < "$file"
+    [ -z "$list_key" ] || manifest_option "$list_key" "${list_value#,}"
+}
+
+# Function to append the flag for manifest option $1 with value $2 to "manifest_args" (called from read_manifest)
+manifest_option() {
+    case "$1" in
+        fields|indexes|page-by|validator|id-field|cache|offload|kind|source) manifest_args+=("--$1" "$2") ;;
+        lean-reads|replica-reads|outbox)
+            case "$2" in
+                true) manifest_args+=("--$1") ;;
+                false) ;;
+                *)
+                    echo "Error: $file:$lineno: $1 must be true or false"
+                    return 1
+                    ;;
+            esac
+            ;;
+        *)
+            echo "Error: $file:$lineno: unknown manifest option '$1'"
+            return 1
+            ;;
+    esac
+}
+
+# Function to register a feature with default per-feature options
+add_feature() {
+    FEATURES+=("$1")
+    FIELD_DEFS+=("")
+    INDEX_DEFS+=("")
+    PAGE_KEYS+=("_id")
+    LEAN_READS+=("false")
+    REPLICA_READS+=("false")
+    VALIDATORS+=("zod")
+    ID_FIELDS+=("id")
+    CACHES+=("none")
+    OFFLOADS+=("none")
+    OUTBOXES+=("false")
+    KINDS+=("crud")
+    SOURCES+=("")
 }
 
 # Parse command-line arguments
 if [ $# -eq 0 ]; then
-    echo "Usage: $0 <project-name> [path] [--feature <feature-name> --fields <field1:type1:rule1,field2:type2:rule2> ...]"
-    echo "       $0 feature <feature-name> [--fields <field1:type1:rule1,field2:type2:rule2>]"
+    echo "Usage: $0 <project-name> [path] [--result closure|class] [--di-scope singleton|transient|request] [--cluster | --workers <n>] [--perf] [--http express|fastify] [--metrics] [--tracing] [--protect] [--build tsc|esbuild] [--target server|lambda] [--timings] [--install npm|skip|offline|pnpm] [--feature <feature-name> --fields <field1:type1:rule1,field2:type2:rule2> [--indexes <field1+field2>] [--page-by <field>] [--lean-reads] [--replica-reads] [--validator zod|inline] [--id-field id|_id] [--cache memory|redis] [--offload none|worker] [--outbox] [--kind crud|readmodel --source <feature>] ...]"
+    echo "       $0 apply [tsclean.yaml] [--jobs <n>] [--force] [--timings] [--install npm|skip|offline|pnpm]"
+    echo "       $0 feature <feature-name> [--fields <field1:type1:rule1,field2:type2:rule2>] [--indexes <field1+field2>] [--page-by <field>] [--lean-reads] [--replica-reads] [--validator zod|inline] [--id-field id|_id] [--cache memory|redis] [--offload none|worker] [--outbox] [--kind crud|readmodel --source <feature>] [--timings] [--install npm|skip|offline|pnpm]"
     echo "Example: $0 FoodStore ./ --feature products --fields name:string:minlength=3,price:number:min=0"
     exit 1
 fi
@@ -106,20 +736,51 @@ if [ "$COMMAND" = "feature" ]; then
         echo "Error: feature command requires a feature name"
         exit 1
     fi
-    feature="$1"
+    current_feature="$1"
     shift
-    fields=""
-    if [ "$1" = "--fields" ]; then
+    add_feature "$current_feature"
+    PROJECT_ROOT="$(pwd)"
+    load_project_settings
+elif [ "$COMMAND" = "apply" ]; then
+    MANIFEST="tsclean.yaml"
+    if [ $# -gt 0 ] && [[ "$1" != --* ]]; then
+        MANIFEST="$1"
         shift
-        if [ -z "$1" ]; then
-            echo "Error: --fields requires a comma-separated list of field:type:rule pairs"
-            exit 1
-        fi
-        fields="$1"
     fi
-    FEATURES+=("$feature")
-    FIELD_DEFS+=("$fields")
     PROJECT_ROOT="$(pwd)"
+    load_project_settings
+    read_manifest "$MANIFEST" || exit 1
+    if [ "${#manifest_args[@]}" -eq 0 ]; then
+        echo "Error: $MANIFEST defines no features"
+        exit 1
+    fi
+    # Options of apply itself; the manifest's feature flags then go through the parser below
+    GENERATE_JOBS=$(getconf _NPROCESSORS_ONLN 2> /dev/null || echo 4)
+    FORCE_APPLY="false"
+    apply_args=()
+    while [ $# -gt 0 ]; do
+        case "$1" in
+            --jobs)
+                shift
+                if ! [[ "$1" =~ ^[1-9][0-9]*$ ]]; then
+                    echo "Error: --jobs requires a positive number"
+                    exit 1
+                fi
+                GENERATE_JOBS="$1"
+                ;;
+            --force) FORCE_APPLY="true" ;;
+            --timings) apply_args+=("$1") ;;
+            --install) apply_args+=("$1" "$2") && shift ;;
+            --install=*) apply_args+=("$1") ;;
+            *)
+                echo "Unknown argument: $1"
+                exit 1
+                ;;
+        esac
+        shift
+    done
+    set -- "${manifest_args[@]}" "${apply_args[@]}"
+    current_feature=""
 else
     PROJECT_NAME="$COMMAND"
     if [ $# -gt 0 ] && [[ "$1" != --* ]]; then
@@ -127,70 +788,442 @@ else
         shift
     fi
     current_feature=""
-    while [ $# -gt 0 ]; do
-        if [ "$1" = "--feature" ]; then
-            shift
-            if [ -z "$1" ]; then
-                echo "Error: --feature requires a feature name"
+    PROJECT_ROOT="$PATH_SPECIFIED/$PROJECT_NAME"
+fi
+
+# Feature-scoped flags apply to the most recent --feature (or to the feature being added)
+last=$((${#FEATURES[@]} - 1))
+while [ $# -gt 0 ]; do
+    if [ "$1" = "--feature" ]; then
+        shift
+        if [ "$COMMAND" = "feature" ]; then
+            echo "Error: feature command adds a single feature; run it once per feature"
+            exit 1
+        fi
+        if [ -z "$1" ]; then
+            echo "Error: --feature requires a feature name"
+            exit 1
+        fi
+        current_feature="$1"
+        add_feature "$current_feature"
+        last=$((${#FEATURES[@]} - 1))
+    elif [ "$1" = "--fields" ]; then
+        shift
+        if [ -z "$current_feature" ]; then
+            echo "Error: --fields must follow a --feature flag"
+            exit 1
+        fi
+        if [ -z "$1" ]; then
+            echo "Error: --fields requires a comma-separated list of field:type:rule pairs"
+            exit 1
+        fi
+        FIELD_DEFS[$last]="$1"
+    elif [ "$1" = "--indexes" ]; then
+        shift
+        if [ -z "$current_feature" ]; then
+            echo "Error: --indexes must follow a --feature flag"
+            exit 1
+        fi
+        if [ -z "$1" ]; then
+            echo "Error: --indexes requires a comma-separated list of field+field compound indexes"
+            exit 1
+        fi
+        INDEX_DEFS[$last]="$1"
+    elif [ "$1" = "--page-by" ]; then
+        shift
+        if [ -z "$current_feature" ]; then
+            echo "Error: --page-by must follow a --feature flag"
+            exit 1
+        fi
+        if [ -z "$1" ]; then
+            echo "Error: --page-by requires a field name"
+            exit 1
+        fi
+        PAGE_KEYS[$last]="$1"
+    elif [ "$1" = "--lean-reads" ]; then
+        if [ -z "$current_feature" ]; then
+            echo "Error: --lean-reads must follow a --feature flag"
+            exit 1
+        fi
+        LEAN_READS[$last]="true"
+    elif [ "$1" = "--replica-reads" ]; then
+        if [ -z "$current_feature" ]; then
+            echo "Error: --replica-reads must follow a --feature flag"
+            exit 1
+        fi
+        REPLICA_READS[$last]="true"
+    elif [ "$1" = "--outbox" ]; then
+        if [ -z "$current_feature" ]; then
+            echo "Error: --outbox must follow a --feature flag"
+            exit 1
+        fi
+        OUTBOXES[$last]="true"
+    elif [ "$1" = "--cache" ]; then
+        shift
+        if [ -z "$current_feature" ]; then
+            echo "Error: --cache must follow a --feature flag"
+            exit 1
+        fi
+        case "$1" in
+            memory|redis) CACHES[$last]="$1" ;;
+            *)
+                echo "Error: --cache must be 'memory' or 'redis'"
                 exit 1
-            fi
-            current_feature="$1"
-            FEATURES+=("$current_feature")
-            FIELD_DEFS+=("")
-        elif [ "$1" = "--fields" ]; then
-            shift
-            if [ -z "$current_feature" ]; then
-                echo "Error: --fields must follow a --feature flag"
+                ;;
+        esac
+    elif [ "$1" = "--kind" ]; then
+        shift
+        if [ -z "$current_feature" ]; then
+            echo "Error: --kind must follow a --feature flag"
+            exit 1
+        fi
+        case "$1" in
+            crud|readmodel) KINDS[$last]="$1" ;;
+            *)
+                echo "Error: --kind must be 'crud' or 'readmodel'"
                 exit 1
-            fi
-            if [ -z "$1" ]; then
-                echo "Error: --fields requires a comma-separated list of field:type:rule pairs"
+                ;;
+        esac
+    elif [ "$1" = "--source" ]; then
+        shift
+        if [ -z "$current_feature" ]; then
+            echo "Error: --source must follow a --feature flag"
+            exit 1
+        fi
+        if ! [[ "$1" =~ ^[A-Za-z][A-Za-z0-9_]*$ ]]; then
+            echo "Error: --source requires a feature name"
+            exit 1
+        fi
+        SOURCES[$last]="$1"
+    elif [ "$1" = "--offload" ]; then
+        shift
+        if [ -z "$current_feature" ]; then
+            echo "Error: --offload must follow a --feature flag"
+            exit 1
+        fi
+        case "$1" in
+            none|worker) OFFLOADS[$last]="$1" ;;
+            *)
+                echo "Error: --offload must be 'none' or 'worker'"
                 exit 1
-            fi
-            FIELD_DEFS[${#FIELD_DEFS[@]}-1]="$1"
-        else
-            echo "Unknown argument: $1"
+                ;;
+        esac
+    elif [ "$1" = "--id-field" ]; then
+        shift
+        if [ -z "$current_feature" ]; then
+            echo "Error: --id-field must follow a --feature flag"
             exit 1
         fi
+        case "$1" in
+            id|_id) ID_FIELDS[$last]="$1" ;;
+            *)
+                echo "Error: --id-field must be 'id' or '_id'"
+                exit 1
+                ;;
+        esac
+    elif [ "$1" = "--validator" ]; then
         shift
-    done
-    PROJECT_ROOT="$PATH_SPECIFIED/$PROJECT_NAME"
-fi
-
-# Check Node.js
-if ! command -v node &> /dev/null; then
-    echo "Node.js is not installed. Please install Node.js version $NODE_VERSION or higher."
-    exit 1
-fi
-
-NODE_MAJOR=$(node -v | cut -d. -f1 | cut -dv -f2)
-if [ "$NODE_MAJOR" -lt "$NODE_VERSION" ]; then
-    echo "Node.js version $NODE_VERSION or higher is required. Found: $(node -v)"
-    exit 1
-fi
-
-# Check npm
-if ! command -v npm &> /dev/null; then
-    echo "npm is not installed. Please install npm."
-    exit 1
-fi
-
-# Check TypeScript
-if ! command -v tsc &> /dev/null; then
-    echo "TypeScript is not installed globally. Installing..."
-    npm install -g typescript
-fi
-
-# If adding a feature, update existing project
-if [ "$COMMAND" = "feature" ]; then
-    if [ ! -f "Server/index.ts" ]; then
-        echo "Error: Current directory is not a tsclean project. Run from the project root."
-        exit 1
-    fi
-    echo "Adding feature: ${FEATURES[0]}"
-else
-    # Create project directory
-    if [ -d "$PROJECT_ROOT" ]; then
+        if [ -z "$current_feature" ]; then
+            echo "Error: --validator must follow a --feature flag"
+            exit 1
+        fi
+        case "$1" in
+            zod|inline) VALIDATORS[$last]="$1" ;;
+            *)
+                echo "Error: --validator must be 'zod' or 'inline'"
+                exit 1
+                ;;
+        esac
+    elif [ "$1" = "--di-scope" ] && [ "$COMMAND" != "feature" ]; then
+        shift
+        case "$1" in
+            singleton|transient|request) DI_SCOPE="$1" ;;
+            *)
+                echo "Error: --di-scope must be 'singleton', 'transient' or 'request'"
+                exit 1
+                ;;
+        esac
+    elif [ "$1" = "--http" ] && [ "$COMMAND" != "feature" ]; then
+        shift
+        case "$1" in
+            express|fastify) HTTP_FRAMEWORK="$1" ;;
+            *)
+                echo "Error: --http must be 'express' or 'fastify'"
+                exit 1
+                ;;
+        esac
+    elif [ "$1" = "--perf" ] && [ "$COMMAND" != "feature" ]; then
+        PERF="true"
+    elif [ "$1" = "--metrics" ] && [ "$COMMAND" != "feature" ]; then
+        METRICS="true"
+    elif [ "$1" = "--tracing" ] && [ "$COMMAND" != "feature" ]; then
+        TRACING="true"
+    elif [ "$1" = "--protect" ] && [ "$COMMAND" != "feature" ]; then
+        PROTECT="true"
+    elif [ "$1" = "--build" ] && [ "$COMMAND" != "feature" ]; then
+        shift
+        case "$1" in
+            tsc|esbuild) BUILD="$1" ;;
+            *)
+                echo "Error: --build must be 'tsc' or 'esbuild'"
+                exit 1
+                ;;
+        esac
+    elif [ "$1" = "--target" ] && [ "$COMMAND" != "feature" ]; then
+        shift
+        case "$1" in
+            server|lambda) TARGET="$1" ;;
+            cloudflare)
+                # Mongoose holds TCP sockets in a pool, and a Worker may not reuse a socket across requests
+                echo "Error: --target cloudflare is not supported: a Worker would have to open and close the MongoDB connection on every request, one request at a time"
+                exit 1
+                ;;
+            *)
+                echo "Error: --target must be 'server' or 'lambda'"
+                exit 1
+                ;;
+        esac
+    elif [ "$1" = "--timings" ]; then
+        TIMINGS="true"
+    elif [ "$1" = "--install" ] || [[ "$1" == --install=* ]]; then
+        if [ "$1" = "--install" ]; then
+            shift
+            INSTALL_MODE="$1"
+        else
+            INSTALL_MODE="${1#--install=}"
+        fi
+        case "$INSTALL_MODE" in
+            npm|skip|offline|pnpm) ;;
+            *)
+                echo "Error: --install must be 'npm', 'skip', 'offline' or 'pnpm'"
+                exit 1
+                ;;
+        esac
+    elif [ "$1" = "--cluster" ] && [ "$COMMAND" != "feature" ]; then
+        CLUSTER="true"
+    elif [ "$1" = "--workers" ] && [ "$COMMAND" != "feature" ]; then
+        shift
+        if ! [[ "$1" =~ ^[1-9][0-9]*$ ]]; then
+            echo "Error: --workers requires a positive number"
+            exit 1
+        fi
+        CLUSTER="true"
+        WORKERS="$1"
+    elif [ "$1" = "--result" ] && [ "$COMMAND" != "feature" ]; then
+        shift
+        case "$1" in
+            closure|class) RESULT_STYLE="$1" ;;
+            *)
+                echo "Error: --result must be 'closure' or 'class'"
+                exit 1
+                ;;
+        esac
+    else
+        echo "Unknown argument: $1"
+        exit 1
+    fi
+    shift
+done
+
+# From here on 'apply' is a 'feature' run over many features; REGENERATE marks the ones whose definition
+# (or the generator, its templates and the project settings) changed since the hashes recorded in .tsclean-apply
+APPLY="false"
+if [ "$COMMAND" = "apply" ]; then
+    APPLY="true"
+    COMMAND="feature"
+    declare -a applied_hashes
+    read -r generator_sum _ < <(cat "${BASH_SOURCE[0]}" "$TEMPLATE_DIR"/feature/*.tpl .tsclean 2> /dev/null | cksum)
+    changed_count=0
+    for i in "${!FEATURES[@]}"; do
+        feature="${FEATURES[$i]}"
+        for j in "${!FEATURES[@]}"; do
+            if [ "$j" -lt "$i" ] && [ "${FEATURES[$j]}" = "$feature" ]; then
+                echo "Error: $MANIFEST defines '$feature' more than once"
+                exit 1
+            fi
+        done
+        read -r applied_hashes[$i] _ < <(printf '%s|' "$generator_sum" "${FIELD_DEFS[$i]}" "${INDEX_DEFS[$i]}" "${PAGE_KEYS[$i]}" \
+            "${LEAN_READS[$i]}" "${REPLICA_READS[$i]}" "${VALIDATORS[$i]}" "${ID_FIELDS[$i]}" "${CACHES[$i]}" "${OFFLOADS[$i]}" "${OUTBOXES[$i]}" "${KINDS[$i]}" "${SOURCES[$i]}" | cksum)
+        REGENERATE[$i]="true"
+        if [ "$FORCE_APPLY" != "true" ] && [ -f "Features/$feature/container.ts" ] && [ -f .tsclean-apply ] &&
+            grep -qx "$feature=${applied_hashes[$i]}" .tsclean-apply; then
+            REGENERATE[$i]="false"
+        else
+            changed_count=$((changed_count + 1))
+        fi
+    done
+fi
+
+# Fastify plugins are registered once at startup, so there is no per-request controller to scope services to
+if [ "$HTTP_FRAMEWORK" = "fastify" ] && [ "$DI_SCOPE" = "request" ]; then
+    echo "Error: --di-scope request is only supported with --http express"
+    exit 1
+fi
+
+# Worker threads load their task modules by file path, which a single-file bundle no longer has
+if [ "$BUILD" = "esbuild" ] && [[ " ${OFFLOADS[*]} " == *" worker "* ]]; then
+    echo "Error: --offload worker is not supported with --build esbuild"
+    exit 1
+fi
+
+# Projects generated when --target cloudflare existed
+if [ "$TARGET" = "cloudflare" ]; then
+    echo "Error: --target cloudflare is no longer supported (Mongoose cannot keep a connection in a Worker); set TARGET=server or TARGET=lambda in .tsclean"
+    exit 1
+fi
+
+# A cache miss would store whatever a lagging secondary returned and serve it past the staleness bound until CACHE_TTL_MS
+for i in "${!FEATURES[@]}"; do
+    if [ "${CACHES[$i]}" != "none" ] && [ "${REPLICA_READS[$i]}" = "true" ]; then
+        echo "Error: --cache cannot be combined with --replica-reads (${FEATURES[$i]})"
+        exit 1
+    fi
+done
+
+# A read model aggregates a CRUD feature generated earlier or in the same run; its --fields name the group keys
+# and, as numbers, the source fields it totals
+for i in "${!FEATURES[@]}"; do
+    feature="${FEATURES[$i]}"
+    source="${SOURCES[$i]}"
+    if [ "${KINDS[$i]}" != "readmodel" ]; then
+        if [ -n "$source" ]; then
+            echo "Error: --source is only used with --kind readmodel ($feature)"
+            exit 1
+        fi
+        continue
+    fi
+    if [ -z "$source" ]; then
+        echo "Error: --kind readmodel requires --source <feature> ($feature)"
+        exit 1
+    fi
+    if [ -n "${INDEX_DEFS[$i]}" ] || [ "${PAGE_KEYS[$i]}" != "_id" ] || [ "${LEAN_READS[$i]}" = "true" ] ||
+        [ "${REPLICA_READS[$i]}" = "true" ] || [ "${VALIDATORS[$i]}" != "zod" ] || [ "${ID_FIELDS[$i]}" != "id" ] || [ "${CACHES[$i]}" != "none" ] ||
+        [ "${OFFLOADS[$i]}" != "none" ] || [ "${OUTBOXES[$i]}" = "true" ]; then
+        echo "Error: --kind readmodel takes only --source and --fields ($feature)"
+        exit 1
+    fi
+    source_fields=""
+    for j in "${!FEATURES[@]}"; do
+        if [ "${FEATURES[$j]}" = "$source" ] && [ "${KINDS[$j]}" = "crud" ]; then
+            source_fields=",${FIELD_DEFS[$j]:-name:string:minlength=3,email:string:email},"
+        fi
+    done
+    source_model="Features/$source/data/models/$source.model.ts"
+    if [ -z "$source_fields" ] && { [ "$COMMAND" != "feature" ] || [ ! -f "$source_model" ] ||
+        [ -f "Features/$source/data/projections/$source.projection.ts" ]; }; then
+        echo "Error: read model $feature needs a CRUD feature '$source' as its --source"
+        exit 1
+    fi
+    parse_fields "${FIELD_DEFS[$i]}"
+    for j in "${!field_names[@]}"; do
+        name="${field_names[$j]}"
+        case "$name" in
+            _id|count|refreshedAt)
+                echo "Error: read model $feature cannot have a field named '$name'; every row has one"
+                exit 1
+                ;;
+        esac
+        if [ -n "$source_fields" ]; then
+            [[ "$source_fields" == *",$name:"* ]] && continue
+        elif grep -q "^  $name: {" "$source_model"; then
+            continue
+        fi
+        echo "Error: read model $feature groups or totals '$name', which $source does not have"
+        exit 1
+    done
+done
+
+# The outbox relay runs for the whole project once any feature has used --outbox
+if [[ " ${OUTBOXES[*]} " == *" true "* ]] || { [ "$COMMAND" = "feature" ] && [ -f Core/outbox/relay.ts ]; }; then
+    USES_OUTBOX="true"
+else
+    USES_OUTBOX="false"
+fi
+
+# Redis is only a dependency when some feature caches through it or the outbox relay publishes to it
+if [[ " ${CACHES[*]} " == *" redis "* ]] || [ "$USES_OUTBOX" = "true" ]; then
+    USES_REDIS="true"
+else
+    USES_REDIS="false"
+fi
+# The platform entry point that --target lambda generates next to Server/index.ts
+case "$TARGET" in
+    lambda) SERVER_ENTRY="Server/lambda.ts" ;;
+    *) SERVER_ENTRY="" ;;
+esac
+# The load benchmark runs against the production build
+if [ "$BUILD" = "esbuild" ]; then
+    BENCH_SCRIPT="npm run build && ts-node bench/load/run.ts"
+else
+    BENCH_SCRIPT="tsc && ts-node bench/load/run.ts"
+fi
+phase_done "arguments"
+
+# An existing project with a lockfile, or the marker left by an earlier run, has already shown that node and npm
+# work, so 'tsclean feature' skips probing them (TSCLEAN_CHECK_TOOLCHAIN=1 probes anyway)
+TOOLCHAIN_MARKER="node_modules/.cache/tsclean/toolchain"
+toolchain_found=""
+if [ "$COMMAND" = "feature" ] && [ "$TSCLEAN_CHECK_TOOLCHAIN" != "1" ]; then
+    for marker in package-lock.json pnpm-lock.yaml yarn.lock "$TOOLCHAIN_MARKER"; do
+        if [ -f "$marker" ]; then
+            toolchain_found="$marker"
+            break
+        fi
+    done
+fi
+if [ -n "$toolchain_found" ]; then
+    echo "Skipped toolchain checks ($toolchain_found found)"
+else
+    # Check Node.js
+    if ! command -v node &> /dev/null; then
+        echo "Node.js is not installed. Please install Node.js version $NODE_VERSION or higher."
+        exit 1
+    fi
+
+    NODE_MAJOR=$(node -v)
+    NODE_MAJOR="${NODE_MAJOR#v}"
+    NODE_MAJOR="${NODE_MAJOR%%.*}"
+    if [ "$NODE_MAJOR" -lt "$NODE_VERSION" ]; then
+        echo "Node.js version $NODE_VERSION or higher is required. Found: $(node -v)"
+        exit 1
+    fi
+
+    # Check npm
+    if ! command -v npm &> /dev/null; then
+        echo "npm is not installed. Please install npm."
+        exit 1
+    fi
+    if [ "$INSTALL_MODE" = "pnpm" ] && ! command -v pnpm &> /dev/null; then
+        echo "pnpm is not installed. Install it (corepack enable pnpm) or choose another --install mode."
+        exit 1
+    fi
+
+    # Check TypeScript
+    if ! command -v tsc &> /dev/null; then
+        echo "TypeScript is not installed globally. Installing..."
+        npm install -g typescript
+    fi
+    if [ "$COMMAND" = "feature" ]; then
+        mkdir -p "${TOOLCHAIN_MARKER%/*}" && echo "node $NODE_MAJOR" > "$TOOLCHAIN_MARKER"
+    fi
+fi
+phase_done "toolchain"
+load_templates
+
+# If adding a feature, update existing project
+if [ "$COMMAND" = "feature" ]; then
+    if [ ! -f "Server/index.ts" ]; then
+        echo "Error: Current directory is not a tsclean project. Run from the project root."
+        exit 1
+    fi
+    if [ "$APPLY" = "true" ]; then
+        echo "Applying $MANIFEST: ${#FEATURES[@]} features, $changed_count to generate"
+    else
+        echo "Adding feature: ${FEATURES[0]}"
+    fi
+else
+    # Create project directory
+    if [ -d "$PROJECT_ROOT" ]; then
         echo "Directory $PROJECT_ROOT already exists. Please remove it or choose a different name."
         exit 1
     fi
@@ -198,60 +1231,129 @@ else
     cd "$PROJECT_ROOT" || exit
     echo "Setting up project: $PROJECT_NAME"
 
-    # Initialize Node.js project
-    npm init -y > /dev/null
-    echo "Initialized Node.js project"
+    # Record project-wide options so later 'tsclean feature' runs generate matching code
+    cat > .tsclean << EOL
+RESULT_STYLE=$RESULT_STYLE
+DI_SCOPE=$DI_SCOPE
+CLUSTER=$CLUSTER
+WORKERS=$WORKERS
+PERF=$PERF
+HTTP_FRAMEWORK=$HTTP_FRAMEWORK
+METRICS=$METRICS
+TRACING=$TRACING
+PROTECT=$PROTECT
+BUILD=$BUILD
+TARGET=$TARGET
+INSTALL_MODE=$INSTALL_MODE
+EOL
+    echo "Created .tsclean"
 
     # Create package.json
+    # reflect-metadata is the polyfill tsyringe needs; every container.ts and Server/index.ts imports it
+    dependencies=('"dotenv": "^16.4.5"' '"mongoose": "^8.7.2"' '"reflect-metadata": "^0.2.2"' '"tsyringe": "^4.8.0"'
+        '"zod": "^3.23.8"')
+    dev_dependencies=('"@types/jest": "^29.5.13"' '"@types/node": "^22.7.5"' '"jest": "^29.7.0"'
+        '"ts-jest": "^29.2.5"' '"ts-node": "^10.9.2"' '"typescript": "^5.6.3"'
+        '"autocannon": "^7.15.0"' '"@types/autocannon": "^7.12.5"' '"mongodb-memory-server": "^10.1.2"')
+    # --build esbuild: a bundled production build and a dev runner that transpiles without type checking
+    if [ "$BUILD" = "esbuild" ]; then
+        dev_dependencies+=('"esbuild": "^0.24.0"' '"tsx": "^4.19.1"')
+        build_scripts='"build": "node build.mjs",
+    "typecheck": "tsc --noEmit",
+    "dev": "tsx watch Server/index.ts",'
+    else
+        dev_dependencies+=('"nodemon": "^3.1.7"')
+        build_scripts='"build": "tsc",
+    "dev": "nodemon Server/index.ts",'
+    fi
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        dependencies+=('"fastify": "^4.28.1"')
+        [ "$PERF" = "true" ] && dependencies+=('"@fastify/compress": "^7.0.3"' '"@fastify/etag": "^5.2.0"')
+    else
+        dependencies+=('"express": "^4.21.1"')
+        dev_dependencies+=('"@types/express": "^5.0.0"' '"@types/supertest": "^6.0.2"' '"supertest": "^7.0.0"')
+        [ "$PERF" = "true" ] && dependencies+=('"compression": "^1.7.4"') && dev_dependencies+=('"@types/compression": "^1.7.5"')
+    fi
+    [ "$USES_REDIS" = "true" ] && dependencies+=('"ioredis": "^5.4.1"')
+    if [ "$TRACING" = "true" ]; then
+        dependencies+=('"@opentelemetry/api": "^1.9.0"' '"@opentelemetry/context-async-hooks": "^1.27.0"'
+            '"@opentelemetry/exporter-trace-otlp-http": "^0.54.0"' '"@opentelemetry/instrumentation": "^0.54.0"'
+            '"@opentelemetry/instrumentation-http": "^0.54.0"' '"@opentelemetry/instrumentation-mongoose": "^0.43.0"'
+            '"@opentelemetry/resources": "^1.27.0"' '"@opentelemetry/sdk-trace-base": "^1.27.0"'
+            '"@opentelemetry/sdk-trace-node": "^1.27.0"' '"@opentelemetry/semantic-conventions": "^1.27.0"')
+    fi
+    # --target lambda: the event types for Server/lambda.ts
+    [ "$TARGET" = "lambda" ] && dev_dependencies+=('"@types/aws-lambda": "^8.10.145"')
     cat > package.json << EOL
 {
   "name": "$PROJECT_NAME",
   "version": "1.0.0",
-  "description": "Express API with TypeScript, MongoDB, and clean architecture",
+  "description": "$(capitalize "$HTTP_FRAMEWORK") API with TypeScript, MongoDB, and clean architecture",
   "main": "dist/Server/index.js",
   "scripts": {
     "start": "node dist/Server/index.js",
-    "build": "tsc",
-    "dev": "nodemon Server/index.ts",
+    $build_scripts
     "test": "jest",
-    "test:watch": "jest --watch"
+    "test:watch": "jest --watch",
+    "bench": "$BENCH_SCRIPT",
+    "bench:result": "node --expose-gc -r ts-node/register bench/result.bench.ts"
   },
   "dependencies": {
-    "dotenv": "^16.4.5",
-    "express": "^4.21.1",
-    "mongoose": "^8.7.2",
-    "tsyringe": "^4.8.0",
-    "zod": "^3.23.8"
+    $(IFS=$'\n'; LC_ALL=C sort <<< "${dependencies[*]}" | sed '$!s/$/,/' | sed '2,$s/^/    /')
+  },
+  "optionalDependencies": {
+    "@mongodb-js/zstd": "^1.2.2",
+    "snappy": "^7.2.2"
   },
   "devDependencies": {
-    "@types/express": "^5.0.0",
-    "@types/jest": "^29.5.13",
-    "@types/node": "^22.7.5",
-    "@types/supertest": "^6.0.2",
-    "jest": "^29.7.0",
-    "nodemon": "^3.1.7",
-    "supertest": "^7.0.0",
-    "ts-jest": "^29.2.5",
-    "ts-node": "^10.9.2",
-    "typescript": "^5.6.3"
+    $(IFS=$'\n'; LC_ALL=C sort <<< "${dev_dependencies[*]}" | sed '$!s/$/,/' | sed '2,$s/^/    /')
   }
 }
 EOL
     echo "Created package.json"
 
     # Install dependencies
-    echo "Installing dependencies..."
-    npm install > /dev/null 2>&1
-    echo "Dependencies installed"
+    install_dependencies
+    mkdir -p "${TOOLCHAIN_MARKER%/*}" && echo "node $NODE_MAJOR" > "$TOOLCHAIN_MARKER"
 
     # Create folder structure
-    mkdir -p Core/config Core/error Core/result Server __tests__
+    mkdir -p Core/config Core/error Core/health Core/http Core/id Core/result Server __tests__ bench
+    [ "$METRICS" = "true" ] && mkdir -p Core/metrics
+    [ "$TRACING" = "true" ] && mkdir -p Core/tracing
+    [ "$PROTECT" = "true" ] && mkdir -p Core/middleware
     echo "Created core folder structure"
 
     # Create .env
     cat > .env << EOL
 PORT=3000
 MONGODB_URI=mongodb://localhost:27017/$PROJECT_NAME
+BULK_BATCH_SIZE=500
+BULK_MAX_ITEMS=10000
+JSON_BODY_LIMIT=100kb
+BULK_BODY_LIMIT=10mb
+NDJSON_MAX_LINE_BYTES=1048576
+SHUTDOWN_TIMEOUT_MS=10000
+MONGO_SYNC_INDEXES=false
+MONGO_POOL_MIN=5
+MONGO_POOL_MAX=50
+MONGO_WAIT_QUEUE_TIMEOUT_MS=2000
+MONGO_SERVER_SELECTION_TIMEOUT_MS=5000
+MONGO_SOCKET_TIMEOUT_MS=30000
+MONGO_COMPRESSORS=zstd,snappy,zlib
+MONGO_READ_PREFERENCE=primary
+CACHE_TTL_MS=30000
+CACHE_MEMORY_TTL_MS=5000
+CACHE_MAX_ENTRIES=10000$(
+[ "$USES_REDIS" = "true" ] && printf '\nREDIS_URL=redis://localhost:6379'
+[ "$CLUSTER" = "true" ] && printf '\nCLUSTER_WORKERS=%s\nCLUSTER_MAX_RESTARTS=10\nCLUSTER_RESTART_WINDOW_MS=60000' "$WORKERS"
+[ "$PERF" = "true" ] && printf '\nCOMPRESSION_THRESHOLD=1024\nKEEP_ALIVE_TIMEOUT_MS=65000\nHEADERS_TIMEOUT_MS=66000\nREQUEST_TIMEOUT_MS=30000'
+[ "$TRACING" = "true" ] && printf '\nOTEL_SERVICE_NAME=%s\nOTEL_EXPORTER_OTLP_ENDPOINT=http://localhost:4318\nTRACE_SAMPLE_RATIO=0.1' "$PROJECT_NAME"
+[[ " ${OFFLOADS[*]} " == *" worker "* ]] && printf '\nWORKER_POOL_SIZE=0\nWORKER_POOL_MAX_QUEUE=1000'
+[[ " ${REPLICA_READS[*]} " == *" true "* ]] && printf '\nMONGO_REPLICA_READ_PREFERENCE=secondaryPreferred\nMONGO_REPLICA_MAX_STALENESS_SECONDS=90'
+[[ " ${KINDS[*]} " == *" readmodel "* ]] && printf '\nREADMODEL_REBUILD_MS=300000\nREADMODEL_DEBOUNCE_MS=1000\nREADMODEL_REQUEST_POLL_MS=5000\nREADMODEL_REFRESH_MIN_INTERVAL_MS=60000'
+[ "$USES_OUTBOX" = "true" ] && printf '\nOUTBOX_BATCH_SIZE=100\nOUTBOX_POLL_MS=1000\nOUTBOX_STREAM_PREFIX=events:\nOUTBOX_STREAM_MAXLEN=100000'
+[ "$PROTECT" = "true" ] && printf '\nRATE_LIMIT_RPS=100\nRATE_LIMIT_BURST=200\nRATE_LIMIT_KEY=ip\nRATE_LIMIT_MAX_KEYS=10000\nSHED_MAX_IN_FLIGHT=512\nSHED_MAX_EVENT_LOOP_LAG_MS=200'
+)
 EOL
     echo "Created .env"
 
@@ -265,6 +1367,13 @@ EOL
     echo "Created .gitignore"
 
     # Create tsconfig.json
+    # Every injected constructor parameter names its token with @inject, so tsyringe needs no design:paramtypes
+    # metadata; --build esbuild drops it (esbuild cannot emit it) and checks that each file transpiles on its own
+    if [ "$BUILD" = "esbuild" ]; then
+        decorator_options='"isolatedModules": true'
+    else
+        decorator_options='"emitDecoratorMetadata": true'
+    fi
     cat > tsconfig.json << EOL
 {
   "compilerOptions": {
@@ -277,7 +1386,7 @@ EOL
     "skipLibCheck": true,
     "forceConsistentCasingInFileNames": true,
     "experimentalDecorators": true,
-    "emitDecoratorMetadata": true
+    $decorator_options
   },
   "include": ["Core/**/*", "Features/**/*", "Server/**/*", "__tests__/**/*"],
   "exclude": ["node_modules", "dist"]
@@ -285,6 +1394,44 @@ EOL
 EOL
     echo "Created tsconfig.json"
 
+    if [ "$BUILD" = "esbuild" ]; then
+        # Packages left out of the bundle: the MongoDB driver's optional add-ons, which it loads only when installed,
+        # and with --tracing mongoose, which OpenTelemetry instruments by hooking require()
+        build_externals="'@mongodb-js/zstd', 'snappy', 'kerberos', 'mongodb-client-encryption', '@aws-sdk/credential-providers',
+    'gcp-metadata', 'socks', 'aws4'"
+        [ "$TRACING" = "true" ] && build_externals+=", 'mongoose'"
+        # --target lambda bundles the function handler next to the server
+        if [ "$TARGET" = "lambda" ]; then
+            build_entries="entryPoints: ['Server/index.ts', 'Server/lambda.ts'],
+  outdir: 'dist/Server',"
+        else
+            build_entries="entryPoints: ['Server/index.ts'],
+  outfile: 'dist/Server/index.js',"
+        fi
+        # Create build.mjs
+        cat > build.mjs << EOL
+// Bundles Server/index.ts and everything it imports into one minified file, so a cold start reads a single module
+// instead of resolving hundreds of files through node_modules, and nothing is compiled at startup. esbuild only strips
+// types: run npm run typecheck (or npm test) to type check.
+import { build } from 'esbuild';
+
+await build({
+  $build_entries
+  bundle: true,
+  minify: true,
+  keepNames: true,
+  sourcemap: true,
+  platform: 'node',
+  target: 'node$NODE_VERSION',
+  external: [
+    $build_externals,
+  ],
+  logLevel: 'info',
+});
+EOL
+        echo "Created build.mjs"
+    fi
+
     # Create jest.config.ts
     cat > jest.config.ts << EOL
 export default {
@@ -299,7 +1446,83 @@ EOL
     echo "Created jest.config.ts"
 
     # Create Core/result/result.ts
-    cat > Core/result/result.ts << EOL
+    if [ "$RESULT_STYLE" = "class" ]; then
+        # Methods live on the shared prototype, so Ok()/Err() allocate one small object with a fixed shape
+        cat > Core/result/result.ts << EOL
+export type Result<T, E> = Ok<T> | Err<E>;
+
+interface Ok<T> {
+  kind: 'Ok';
+  value: T;
+  isOk(): boolean;
+  isErr(): boolean;
+  unwrap(): T;
+  unwrapErr(): never;
+}
+
+interface Err<E> {
+  kind: 'Err';
+  error: E;
+  isOk(): boolean;
+  isErr(): boolean;
+  unwrap(): never;
+  unwrapErr(): E;
+}
+
+class OkResult<T> implements Ok<T> {
+  readonly kind = 'Ok' as const;
+
+  constructor(readonly value: T) {}
+
+  isOk(): boolean {
+    return true;
+  }
+
+  isErr(): boolean {
+    return false;
+  }
+
+  unwrap(): T {
+    return this.value;
+  }
+
+  unwrapErr(): never {
+    throw new Error('Cannot unwrapErr an Ok value');
+  }
+}
+
+class ErrResult<E> implements Err<E> {
+  readonly kind = 'Err' as const;
+
+  constructor(readonly error: E) {}
+
+  isOk(): boolean {
+    return false;
+  }
+
+  isErr(): boolean {
+    return true;
+  }
+
+  unwrap(): never {
+    throw new Error('Cannot unwrap an Err value');
+  }
+
+  unwrapErr(): E {
+    return this.error;
+  }
+}
+
+export function Ok<T>(value: T): Ok<T> {
+  return new OkResult(value);
+}
+
+export function Err<E>(error: E): Err<E> {
+  return new ErrResult(error);
+}
+EOL
+    else
+        cat > Core/result/result.ts << EOL
 export type Result<T, E> = Ok<T> | Err<E>;
 
 interface Ok<T> {
@@ -320,470 +1543,3013 @@ interface Err<E> {
   unwrapErr(): E;
 }
 
-export function Ok<T>(value: T): Ok<T> {
-  return {
-    kind: 'Ok',
-    value,
-    isOk: () => true,
-    isErr: () => false,
-    unwrap: () => value,
-    unwrapErr: () => { throw new Error('Cannot unwrapErr an Ok value'); },
+export function Ok<T>(value: T): Ok<T> {
+  return {
+    kind: 'Ok',
+    value,
+    isOk: () => true,
+    isErr: () => false,
+    unwrap: () => value,
+    unwrapErr: () => { throw new Error('Cannot unwrapErr an Ok value'); },
+  };
+}
+
+export function Err<E>(error: E): Err<E> {
+  return {
+    kind: 'Err',
+    error,
+    isOk: () => false,
+    isErr: () => true,
+    unwrap: () => { throw new Error('Cannot unwrap an Err value'); },
+    unwrapErr: () => error,
+  };
+}
+EOL
+    fi
+    echo "Created Core/result/result.ts"
+
+    # Create bench/result.bench.ts
+    cat > bench/result.bench.ts << EOL
+// Compares the closure-based Result (tsclean --result closure) with the prototype-shared one (--result class).
+// Run with: npm run bench:result
+type Result<T, E> =
+  | { kind: 'Ok'; value: T; isOk(): boolean; isErr(): boolean; unwrap(): T; unwrapErr(): never }
+  | { kind: 'Err'; error: E; isOk(): boolean; isErr(): boolean; unwrap(): never; unwrapErr(): E };
+
+const closureOk = <T>(value: T): Result<T, never> => ({
+  kind: 'Ok',
+  value,
+  isOk: () => true,
+  isErr: () => false,
+  unwrap: () => value,
+  unwrapErr: () => { throw new Error('Cannot unwrapErr an Ok value'); },
+});
+
+const closureErr = <E>(error: E): Result<never, E> => ({
+  kind: 'Err',
+  error,
+  isOk: () => false,
+  isErr: () => true,
+  unwrap: () => { throw new Error('Cannot unwrap an Err value'); },
+  unwrapErr: () => error,
+});
+
+class OkResult<T> {
+  readonly kind = 'Ok' as const;
+  constructor(readonly value: T) {}
+  isOk(): boolean { return true; }
+  isErr(): boolean { return false; }
+  unwrap(): T { return this.value; }
+  unwrapErr(): never { throw new Error('Cannot unwrapErr an Ok value'); }
+}
+
+class ErrResult<E> {
+  readonly kind = 'Err' as const;
+  constructor(readonly error: E) {}
+  isOk(): boolean { return false; }
+  isErr(): boolean { return true; }
+  unwrap(): never { throw new Error('Cannot unwrap an Err value'); }
+  unwrapErr(): E { return this.error; }
+}
+
+const classOk = <T>(value: T): Result<T, never> => new OkResult(value);
+const classErr = <E>(error: E): Result<never, E> => new ErrResult(error);
+
+const ITERATIONS = Number(process.env.BENCH_ITERATIONS || 5_000_000);
+const gc = (global as { gc?: () => void }).gc;
+
+const run = (label: string, ok: (v: number) => Result<number, never>, err: (e: string) => Result<never, string>) => {
+  // A small ring buffer keeps results alive so the allocations cannot be optimized away
+  const retained: Result<number, string>[] = new Array(1000);
+  let checksum = 0;
+  for (let i = 0; i < 100_000; i++) checksum += ok(i).isOk() ? 1 : 0; // warm-up
+  gc?.();
+  const heapBefore = process.memoryUsage().heapUsed;
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < ITERATIONS; i++) {
+    const result = i % 10 === 0 ? err('failed') : ok(i);
+    retained[i % retained.length] = result;
+    checksum += result.isOk() ? result.unwrap() & 1 : 0;
+  }
+  const elapsed = Number(process.hrtime.bigint() - start);
+  const heapDelta = process.memoryUsage().heapUsed - heapBefore;
+  console.log(
+    label.padEnd(8),
+    (elapsed / ITERATIONS).toFixed(2).padStart(8), 'ns/op',
+    (heapDelta / 1024 / 1024).toFixed(1).padStart(8), 'MB heap delta',
+    '(checksum ' + checksum + ')'
+  );
+};
+
+if (!gc) console.warn('Run with node --expose-gc for stable heap numbers');
+run('closure', closureOk, closureErr);
+run('class', classOk, classErr);
+run('closure', closureOk, closureErr);
+run('class', classOk, classErr);
+EOL
+    echo "Created bench/result.bench.ts"
+
+    # Create Core/error/custom-error.ts
+    cat > Core/error/custom-error.ts << EOL
+export class CustomError extends Error {
+  constructor(public statusCode: number, message: string) {
+    super(message);
+    this.name = 'CustomError';
+  }
+}
+EOL
+    echo "Created Core/error/custom-error.ts"
+
+    # Create Core/error/error-handler.ts
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        cat > Core/error/error-handler.ts << EOL
+import { FastifyError, FastifyRequest, FastifyReply } from 'fastify';
+import { CustomError } from './custom-error';
+
+// Renders errors thrown by route handlers, schema validation failures and body parser errors
+export const errorHandler = (error: FastifyError | CustomError, request: FastifyRequest, reply: FastifyReply) => {
+  if (error instanceof CustomError) {
+    reply.code(error.statusCode).send({ message: error.message });
+    return;
+  }
+  // Ajv validation errors (400) and body limit errors (413) carry their own 4xx status
+  if (error.statusCode && error.statusCode >= 400 && error.statusCode < 500) {
+    reply.code(error.statusCode).send({ message: error.message });
+    return;
+  }
+  console.error('Unhandled error:', error);
+  reply.code(500).send({ message: 'Internal server error' });
+};
+EOL
+    else
+        cat > Core/error/error-handler.ts << EOL
+import { Request, Response, NextFunction } from 'express';
+import { CustomError } from './custom-error';
+
+// Renders errors passed to next(): Err results from middleware, thrown CustomErrors, and anything unexpected
+export const errorHandler = (err: unknown, req: Request, res: Response, next: NextFunction) => {
+  const error = typeof err === 'object' && err !== null && (err as { kind?: unknown }).kind === 'Err'
+    ? (err as { error: unknown }).error
+    : err;
+  if (error instanceof CustomError) {
+    res.status(error.statusCode).json({ message: error.message });
+    return;
+  }
+  // Body parser failures (malformed JSON, entity.too.large) carry their own 4xx status
+  const status = (error as { status?: unknown }).status;
+  if (typeof status === 'number' && status >= 400 && status < 500) {
+    res.status(status).json({ message: (error as Error).message });
+    return;
+  }
+  console.error('Unhandled error:', error);
+  res.status(500).json({ message: 'Internal server error' });
+};
+EOL
+    fi
+    echo "Created Core/error/error-handler.ts"
+
+    # Create Core/id/id.ts
+    cat > Core/id/id.ts << EOL
+import { randomFillSync } from 'node:crypto';
+
+// UUIDv7 (RFC 9562): a 48-bit millisecond timestamp, then a 12-bit counter, then random bits.
+// IDs sort by creation time, so inserts land at the right edge of the unique id index instead of all over it.
+
+const HEX = Array.from({ length: 256 }, (_, byte) => byte.toString(16).padStart(2, '0'));
+
+// Random bytes are drawn from a pool that is refilled in bulk instead of calling into crypto per ID
+const POOL_SIZE = 4096;
+const pool = Buffer.allocUnsafe(POOL_SIZE);
+let poolOffset = POOL_SIZE;
+
+let lastMs = 0;
+let counter = 0;
+// "tttttttt-tttt-7": the timestamp part only changes once per millisecond, so it is formatted once and reused
+let prefix = '';
+
+const setTime = (ms: number) => {
+  lastMs = ms;
+  const time = ms.toString(16).padStart(12, '0');
+  prefix = time.slice(0, 8) + '-' + time.slice(8) + '-7';
+};
+
+export const newId = (): string => {
+  if (poolOffset + 10 > POOL_SIZE) {
+    randomFillSync(pool);
+    poolOffset = 0;
+  }
+  const offset = poolOffset;
+  poolOffset += 10;
+
+  const now = Date.now();
+  if (now > lastMs) {
+    setTime(now);
+    // Start each millisecond low in the counter range so it has room to increase
+    counter = ((pool[offset] & 0x07) << 8) | pool[offset + 1];
+  } else if (++counter > 0xfff) {
+    // Counter exhausted (or the clock went backwards): borrow the next millisecond to stay monotonic
+    setTime(lastMs + 1);
+    counter = 0;
+  }
+
+  return (
+    prefix + (counter >> 8).toString(16) + HEX[counter & 0xff] + '-' +
+    HEX[(pool[offset + 2] & 0x3f) | 0x80] + HEX[pool[offset + 3]] + '-' +
+    HEX[pool[offset + 4]] + HEX[pool[offset + 5]] + HEX[pool[offset + 6]] + HEX[pool[offset + 7]] + HEX[pool[offset + 8]] + HEX[pool[offset + 9]]
+  );
+};
+EOL
+    echo "Created Core/id/id.ts"
+
+    # Create __tests__/Core/id.test.ts
+    mkdir -p __tests__/Core
+    cat > __tests__/Core/id.test.ts << EOL
+import { newId } from '../../Core/id/id';
+
+describe('newId', () => {
+  it('should generate UUIDv7 strings', () => {
+    expect(newId()).toMatch(/^[0-9a-f]{8}-[0-9a-f]{4}-7[0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}\$/);
+  });
+
+  it('should generate unique ids in creation order', () => {
+    const ids = Array.from({ length: 10000 }, () => newId());
+    expect(new Set(ids).size).toBe(ids.length);
+    expect([...ids].sort()).toEqual(ids);
+  });
+});
+EOL
+    echo "Created __tests__/Core/id.test.ts"
+
+    # Create Core/config/database.ts
+    cat > Core/config/database.ts << EOL
+import mongoose, { ConnectOptions } from 'mongoose';
+
+type Compressor = 'zstd' | 'snappy' | 'zlib';
+type ReadPreference = 'primary' | 'primaryPreferred' | 'secondary' | 'secondaryPreferred' | 'nearest';
+
+// zstd and snappy are optional native packages; compressors whose package failed to install are skipped
+const COMPRESSOR_PACKAGES: Record<string, string | null> = { zstd: '@mongodb-js/zstd', snappy: 'snappy', zlib: null };
+
+const isInstalled = (name: string): boolean => {
+  try {
+    require.resolve(name);
+    return true;
+  } catch {
+    return false;
+  }
+};
+
+const numberFromEnv = (name: string): number | undefined => {
+  const value = process.env[name];
+  return value ? Number(value) : undefined;
+};
+
+// Pool, timeout, compression and read preference settings from .env; unset values keep the driver defaults
+export const getConnectOptions = (): ConnectOptions => {
+  const compressors = (process.env.MONGO_COMPRESSORS || '')
+    .split(',')
+    .map((name) => name.trim())
+    .filter((name) => name in COMPRESSOR_PACKAGES)
+    .filter((name) => COMPRESSOR_PACKAGES[name] === null || isInstalled(COMPRESSOR_PACKAGES[name] as string)) as Compressor[];
+  const options: ConnectOptions = {
+    minPoolSize: numberFromEnv('MONGO_POOL_MIN'),
+    maxPoolSize: numberFromEnv('MONGO_POOL_MAX'),
+    waitQueueTimeoutMS: numberFromEnv('MONGO_WAIT_QUEUE_TIMEOUT_MS'),
+    serverSelectionTimeoutMS: numberFromEnv('MONGO_SERVER_SELECTION_TIMEOUT_MS'),
+    socketTimeoutMS: numberFromEnv('MONGO_SOCKET_TIMEOUT_MS'),
+    compressors: compressors.length > 0 ? compressors : undefined,
+    readPreference: process.env.MONGO_READ_PREFERENCE as ReadPreference | undefined,
+  };
+  return Object.fromEntries(Object.entries(options).filter(([, value]) => value !== undefined));
+};
+
+// Live pool counters, fed by the driver's connection pool monitoring events
+const poolStats = { inUse: 0, waiting: 0, checkOutFailures: 0 };
+
+export const getPoolStats = () => ({
+  ...poolStats,
+  minPoolSize: numberFromEnv('MONGO_POOL_MIN') ?? 0,
+  maxPoolSize: numberFromEnv('MONGO_POOL_MAX') ?? 100,
+});
+
+// Counts from the first event on, and never below 0 in case an event is missed (e.g. a checkout that failed over)
+const decrement = (name: 'inUse' | 'waiting') => {
+  poolStats[name] = Math.max(0, poolStats[name] - 1);
+};
+
+const monitorPool = (client: mongoose.mongo.MongoClient) => {
+  client.on('connectionCheckOutStarted', () => poolStats.waiting++);
+  client.on('connectionCheckedOut', () => {
+    decrement('waiting');
+    poolStats.inUse++;
+  });
+  client.on('connectionCheckOutFailed', () => {
+    decrement('waiting');
+    poolStats.checkOutFailures++;
+  });
+  client.on('connectionCheckedIn', () => decrement('inUse'));
+};
+
+export const connectToDatabase = async () => {
+  const uri = process.env.MONGODB_URI;
+  if (!uri) {
+    throw new Error('MONGODB_URI is not defined in .env');
+  }
+  // syncIndexes() below builds every declared index once (and drops undeclared ones), so autoIndex is redundant then
+  const syncIndexes = process.env.MONGO_SYNC_INDEXES === 'true';
+  mongoose.set('autoIndex', !syncIndexes);
+  // The client is built here rather than by mongoose.connect() so the pool listeners are on it before the first
+  // checkout, including those of the index builds that setClient() starts for the registered models
+  const client = new mongoose.mongo.MongoClient(uri, getConnectOptions());
+  monitorPool(client);
+  try {
+    await client.connect();
+  } catch (error) {
+    await client.close();
+    throw error;
+  }
+  mongoose.connection.setClient(client);
+  console.log('Connected to MongoDB');
+  if (syncIndexes) {
+    await mongoose.syncIndexes();
+    console.log('Synchronized MongoDB indexes');
+  }
+};
+EOL
+    echo "Created Core/config/database.ts"
+
+    # Create Core/http/body.ts
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        body_imports=""
+        body_limit_helper="// Route bodyLimit in bytes from a size such as 100kb or 10mb; read when the routes are registered, after dotenv
+export const bodyLimit = (limitVariable: string, defaultLimit: string): number => {
+  const units: Record<string, number> = { b: 1, kb: 1024, mb: 1024 ** 2, gb: 1024 ** 3 };
+  const match = /^(\\d+(?:\\.\\d+)?)\\s*(b|kb|mb|gb)?\$/i.exec(process.env[limitVariable] || defaultLimit);
+  if (!match) throw new Error(limitVariable + ' must be a size such as 100kb or 10mb');
+  return Math.floor(Number(match[1]) * units[(match[2] || 'b').toLowerCase()]);
+};"
+    else
+        body_imports="import express, { Request, Response, NextFunction, RequestHandler } from 'express';
+"
+        body_limit_helper="// Per-route JSON body parser; the limit is read on first use, after dotenv has loaded .env
+export const jsonBody = (limitVariable: string, defaultLimit: string): RequestHandler => {
+  let parser: RequestHandler | null = null;
+  return (req: Request, res: Response, next: NextFunction) => {
+    parser ??= express.json({ limit: process.env[limitVariable] || defaultLimit });
+    parser(req, res, next);
+  };
+};"
+    fi
+    cat > Core/http/body.ts << EOL
+${body_imports}import { Readable } from 'node:stream';
+import { StringDecoder } from 'node:string_decoder';
+import { CustomError } from '../error/custom-error';
+
+$body_limit_helper
+
+// Yields the non-empty lines of an NDJSON stream as they arrive. Only the current partial line is buffered,
+// and the stream is read only as fast as the consumer awaits the next line, so memory stays bounded.
+export async function* ndjsonLines(stream: Readable): AsyncGenerator<string> {
+  const maxLineBytes = Number(process.env.NDJSON_MAX_LINE_BYTES) || 1048576;
+  const decoder = new StringDecoder('utf8');
+  let pending = '';
+  for await (const chunk of stream) {
+    pending += decoder.write(chunk as Buffer);
+    let start = 0;
+    let newline: number;
+    while ((newline = pending.indexOf('\n', start)) !== -1) {
+      const line = pending.slice(start, newline).trim();
+      start = newline + 1;
+      if (line) yield line;
+    }
+    pending = pending.slice(start);
+    if (pending.length > maxLineBytes) {
+      throw new CustomError(413, 'NDJSON lines are limited to ' + maxLineBytes + ' bytes');
+    }
+  }
+  const last = (pending + decoder.end()).trim();
+  if (last) yield last;
+}
+EOL
+    echo "Created Core/http/body.ts"
+
+    # Create Core/health/health.router.ts
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        health_import="import { FastifyInstance } from 'fastify';"
+        health_routes="export const healthRouter = async (app: FastifyInstance): Promise<void> => {
+  // Liveness: the process is up and serving requests
+  app.get('/live', async () => ({ status: 'ok' }));
+
+  app.get('/ready', async (request, reply) => {
+    const { ready, body } = readiness();
+    reply.code(ready ? 200 : 503).send(body);
+  });
+};"
+    else
+        health_import="import { Router } from 'express';"
+        health_routes="export const healthRouter = Router();
+
+// Liveness: the process is up and serving requests
+healthRouter.get('/live', (req, res) => {
+  res.json({ status: 'ok' });
+});
+
+healthRouter.get('/ready', (req, res) => {
+  const { ready, body } = readiness();
+  res.status(ready ? 200 : 503).json(body);
+});"
+    fi
+    cat > Core/health/health.router.ts << EOL
+$health_import
+import mongoose from 'mongoose';
+import { getPoolStats } from '../config/database';
+import { isShuttingDown } from '../http/shutdown';
+
+const MONGO_STATES = ['disconnected', 'connected', 'connecting', 'disconnecting'];
+
+// Readiness: MongoDB is connected, the pool can hand out connections, and the process is not draining for shutdown
+const readiness = () => {
+  const pool = getPoolStats();
+  const connected = mongoose.connection.readyState === 1;
+  const saturated = pool.inUse >= pool.maxPoolSize && pool.waiting > 0;
+  const draining = isShuttingDown();
+  const ready = connected && !saturated && !draining;
+  return {
+    ready,
+    body: {
+      status: draining ? 'draining' : ready ? 'ready' : 'unavailable',
+      mongo: { state: MONGO_STATES[mongoose.connection.readyState] ?? 'unknown', pool },
+    },
+  };
+};
+
+$health_routes
+EOL
+    echo "Created Core/health/health.router.ts"
+
+    # Create Core/metrics/metrics.ts and Core/metrics/metrics.router.ts
+    if [ "$METRICS" = "true" ]; then
+        cat > Core/metrics/metrics.ts << EOL
+import { constants, monitorEventLoopDelay, IntervalHistogram, PerformanceObserver } from 'node:perf_hooks';
+import { getPoolStats } from '../config/database';
+
+// Instrumentation switch. tsc inlines const enum members, so the checks below compile to if (1) / if (0)
+// rather than a property lookup: set Enabled = 0 and rebuild to drop timing from every layer.
+export const enum Metrics {
+  Enabled = 1,
+}
+
+const DEFAULT_BUCKETS = [0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5];
+
+// Renderers for everything exposed on GET /metrics, in registration order
+const registry: (() => string)[] = [];
+
+type Series = { buckets: number[]; sum: number; count: number };
+
+// Prometheus histogram with a single label; buckets are upper bounds in seconds
+export class Histogram {
+  private series = new Map<string, Series>();
+
+  constructor(
+    readonly name: string,
+    readonly help: string,
+    readonly labelName: string,
+    private bounds: number[] = DEFAULT_BUCKETS
+  ) {
+    registry.push(() => this.render());
+  }
+
+  observe(label: string, seconds: number): void {
+    let series = this.series.get(label);
+    if (!series) {
+      series = { buckets: new Array(this.bounds.length).fill(0), sum: 0, count: 0 };
+      this.series.set(label, series);
+    }
+    let index = 0;
+    while (index < this.bounds.length && seconds > this.bounds[index]) index++;
+    if (index < this.bounds.length) series.buckets[index]++;
+    series.sum += seconds;
+    series.count++;
+  }
+
+  render(): string {
+    const lines = ['# HELP ' + this.name + ' ' + this.help, '# TYPE ' + this.name + ' histogram'];
+    for (const [label, series] of this.series) {
+      const labels = this.labelName + '="' + label + '"';
+      let cumulative = 0;
+      this.bounds.forEach((bound, index) => {
+        cumulative += series.buckets[index];
+        lines.push(this.name + '_bucket{' + labels + ',le="' + bound + '"} ' + cumulative);
+      });
+      lines.push(this.name + '_bucket{' + labels + ',le="+Inf"} ' + series.count);
+      lines.push(this.name + '_sum{' + labels + '} ' + series.sum);
+      lines.push(this.name + '_count{' + labels + '} ' + series.count);
+    }
+    return lines.join('\\n');
+  }
+}
+
+const gauge = (name: string, help: string, read: () => number, type = 'gauge') => {
+  registry.push(() => ['# HELP ' + name + ' ' + help, '# TYPE ' + name + ' ' + type, name + ' ' + read()].join('\\n'));
+};
+
+export const handlerDuration = new Histogram('http_handler_duration_seconds', 'Time spent in controller handlers', 'handler');
+export const useCaseDuration = new Histogram('usecase_execute_duration_seconds', 'Time spent in use case execute()', 'usecase');
+export const dataSourceDuration = new Histogram('datasource_call_duration_seconds', 'Time spent in MongoDB datasource calls', 'operation');
+const gcDuration = new Histogram('nodejs_gc_duration_seconds', 'Garbage collection pauses', 'kind', [0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1]);
+
+// Records the duration of every call to the decorated async method, including calls that reject.
+// The check runs once when the class is defined, so with Metrics.Enabled = 0 the method is left untouched.
+export const timed = (histogram: Histogram, label: string) =>
+  (target: object, key: string, descriptor: PropertyDescriptor): PropertyDescriptor => {
+    if (!Metrics.Enabled) return descriptor;
+    const method = descriptor.value as (...args: unknown[]) => Promise<unknown>;
+    descriptor.value = async function (this: unknown, ...args: unknown[]) {
+      const start = process.hrtime.bigint();
+      try {
+        return await method.apply(this, args);
+      } finally {
+        histogram.observe(label, Number(process.hrtime.bigint() - start) / 1e9);
+      }
+    };
+    return descriptor;
+  };
+
+// Event-loop delay percentiles cover the interval since the previous scrape
+let eventLoopDelay: IntervalHistogram | undefined;
+gauge('nodejs_eventloop_lag_p50_seconds', 'Median event-loop delay since the last scrape', () => (eventLoopDelay?.percentile(50) ?? 0) / 1e9);
+gauge('nodejs_eventloop_lag_p99_seconds', '99th percentile event-loop delay since the last scrape', () => (eventLoopDelay?.percentile(99) ?? 0) / 1e9);
+gauge('nodejs_eventloop_lag_max_seconds', 'Longest event-loop delay since the last scrape', () => (eventLoopDelay?.max ?? 0) / 1e9);
+gauge('mongodb_pool_in_use_connections', 'Connections checked out of the MongoDB pool', () => getPoolStats().inUse);
+gauge('mongodb_pool_waiting_requests', 'Operations waiting for a MongoDB connection', () => getPoolStats().waiting);
+gauge('mongodb_pool_max_connections', 'Configured MongoDB maxPoolSize', () => getPoolStats().maxPoolSize);
+gauge('mongodb_pool_checkout_failures_total', 'Failed MongoDB connection checkouts', () => getPoolStats().checkOutFailures, 'counter');
+
+const GC_KINDS: Record<number, string> = {
+  [constants.NODE_PERFORMANCE_GC_MINOR]: 'minor',
+  [constants.NODE_PERFORMANCE_GC_MAJOR]: 'major',
+  [constants.NODE_PERFORMANCE_GC_INCREMENTAL]: 'incremental',
+  [constants.NODE_PERFORMANCE_GC_WEAKCB]: 'weakcb',
+};
+
+// Starts the event-loop delay monitor and the GC observer; called once from Server/index.ts
+export const collectRuntimeMetrics = (): void => {
+  if (!Metrics.Enabled || eventLoopDelay) return;
+  eventLoopDelay = monitorEventLoopDelay({ resolution: 10 });
+  eventLoopDelay.enable();
+  new PerformanceObserver((list) => {
+    for (const entry of list.getEntries()) {
+      const kind = (entry.detail as { kind?: number } | undefined)?.kind;
+      gcDuration.observe((kind !== undefined && GC_KINDS[kind]) || 'unknown', entry.duration / 1000);
+    }
+  }).observe({ entryTypes: ['gc'] });
+};
+
+// Prometheus text exposition format
+export const renderMetrics = (): string => {
+  const text = registry.map((render) => render()).join('\\n') + '\\n';
+  eventLoopDelay?.reset();
+  return text;
+};
+EOL
+        echo "Created Core/metrics/metrics.ts"
+
+        if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+            metrics_router="import { FastifyInstance } from 'fastify';
+import { renderMetrics } from './metrics';
+
+export const metricsRouter = async (app: FastifyInstance): Promise<void> => {
+  app.get('/', async (request, reply) => {
+    reply.type('text/plain; version=0.0.4').send(renderMetrics());
+  });
+};"
+        else
+            metrics_router="import { Router } from 'express';
+import { renderMetrics } from './metrics';
+
+export const metricsRouter = Router();
+
+metricsRouter.get('/', (req, res) => {
+  res.type('text/plain; version=0.0.4').send(renderMetrics());
+});"
+        fi
+        cat > Core/metrics/metrics.router.ts << EOL
+$metrics_router
+EOL
+        echo "Created Core/metrics/metrics.router.ts"
+
+        # Create __tests__/Core/metrics.test.ts
+        cat > __tests__/Core/metrics.test.ts << EOL
+import { Histogram, renderMetrics, timed } from '../../Core/metrics/metrics';
+
+describe('metrics', () => {
+  it('should render cumulative histogram buckets', () => {
+    const histogram = new Histogram('test_duration_seconds', 'Test histogram', 'operation', [0.01, 0.1]);
+    histogram.observe('read', 0.005);
+    histogram.observe('read', 0.05);
+    histogram.observe('read', 1);
+
+    const text = renderMetrics();
+
+    expect(text).toContain('# TYPE test_duration_seconds histogram');
+    expect(text).toContain('test_duration_seconds_bucket{operation="read",le="0.01"} 1');
+    expect(text).toContain('test_duration_seconds_bucket{operation="read",le="0.1"} 2');
+    expect(text).toContain('test_duration_seconds_bucket{operation="read",le="+Inf"} 3');
+    expect(text).toContain('test_duration_seconds_count{operation="read"} 3');
+  });
+
+  it('should time decorated methods, including ones that reject', async () => {
+    const histogram = new Histogram('timed_test_duration_seconds', 'Timed test histogram', 'method');
+    class Service {
+      @timed(histogram, 'Service.run')
+      async run(fail: boolean): Promise<string> {
+        if (fail) throw new Error('failed');
+        return 'done';
+      }
+    }
+    const service = new Service();
+
+    await expect(service.run(false)).resolves.toBe('done');
+    await expect(service.run(true)).rejects.toThrow('failed');
+    expect(histogram.render()).toContain('timed_test_duration_seconds_count{method="Service.run"} 2');
+  });
+});
+EOL
+        echo "Created __tests__/Core/metrics.test.ts"
+    fi
+
+    # Create Core/tracing/tracing.ts and Core/tracing/traced.ts
+    if [ "$TRACING" = "true" ]; then
+        cat > Core/tracing/tracing.ts << EOL
+// OpenTelemetry setup. Imported first by Server/index.ts so the http and mongoose patches are in place before those modules load.
+import 'dotenv/config';
+import { AsyncLocalStorageContextManager } from '@opentelemetry/context-async-hooks';
+import { OTLPTraceExporter } from '@opentelemetry/exporter-trace-otlp-http';
+import { registerInstrumentations } from '@opentelemetry/instrumentation';
+import { HttpInstrumentation } from '@opentelemetry/instrumentation-http';
+import { MongooseInstrumentation } from '@opentelemetry/instrumentation-mongoose';
+import { Resource } from '@opentelemetry/resources';
+import { BatchSpanProcessor, ParentBasedSampler, TraceIdRatioBasedSampler } from '@opentelemetry/sdk-trace-base';
+import { NodeTracerProvider } from '@opentelemetry/sdk-trace-node';
+import { ATTR_SERVICE_NAME } from '@opentelemetry/semantic-conventions';
+
+// TRACE_SAMPLE_RATIO of new traces are recorded; requests that arrive with a traceparent follow the caller's decision.
+// Unsampled requests still carry context, but their spans are non-recording and are never exported.
+const sampleRatio = Number(process.env.TRACE_SAMPLE_RATIO ?? 0.1);
+
+const provider = new NodeTracerProvider({
+  resource: new Resource({ [ATTR_SERVICE_NAME]: process.env.OTEL_SERVICE_NAME || '$PROJECT_NAME' }),
+  sampler: new ParentBasedSampler({ root: new TraceIdRatioBasedSampler(sampleRatio) }),
+});
+// Exports to OTEL_EXPORTER_OTLP_ENDPOINT in batches, off the request path
+provider.addSpanProcessor(new BatchSpanProcessor(new OTLPTraceExporter()));
+// The active span follows each request through awaits via AsyncLocalStorage
+provider.register({ contextManager: new AsyncLocalStorageContextManager() });
+
+// Flushes buffered spans and stops exporting; called by Core/http/shutdown.ts once requests have drained
+export const shutdownTracing = (): Promise<void> => provider.shutdown();
+
+registerInstrumentations({
+  tracerProvider: provider,
+  instrumentations: [
+    new HttpInstrumentation({ ignoreIncomingRequestHook: (request) => request.url?.startsWith('/health') ?? false }),
+    new MongooseInstrumentation(),
+  ],
+});
+EOL
+        echo "Created Core/tracing/tracing.ts"
+
+        cat > Core/tracing/traced.ts << EOL
+import { SpanStatusCode, trace } from '@opentelemetry/api';
+
+const tracer = trace.getTracer('$PROJECT_NAME');
+
+// Runs the decorated async method inside a child span of the active one. Err results are values rather than
+// exceptions, so they mark the span as failed too.
+export const traced = (name: string) =>
+  (target: object, key: string, descriptor: PropertyDescriptor): PropertyDescriptor => {
+    const method = descriptor.value as (...args: unknown[]) => Promise<unknown>;
+    descriptor.value = function (this: unknown, ...args: unknown[]) {
+      return tracer.startActiveSpan(name, async (span) => {
+        try {
+          const result = await method.apply(this, args);
+          const error = (result as { kind?: string; error?: Error } | undefined)?.kind === 'Err' ? (result as { error: Error }).error : undefined;
+          if (error) span.setStatus({ code: SpanStatusCode.ERROR, message: error.message });
+          return result;
+        } catch (error) {
+          span.recordException(error as Error);
+          span.setStatus({ code: SpanStatusCode.ERROR, message: (error as Error).message });
+          throw error;
+        } finally {
+          span.end();
+        }
+      });
+    };
+    return descriptor;
+  };
+EOL
+        echo "Created Core/tracing/traced.ts"
+
+        # Create __tests__/Core/traced.test.ts
+        cat > __tests__/Core/traced.test.ts << EOL
+import { AsyncLocalStorageContextManager } from '@opentelemetry/context-async-hooks';
+import { InMemorySpanExporter, SimpleSpanProcessor } from '@opentelemetry/sdk-trace-base';
+import { NodeTracerProvider } from '@opentelemetry/sdk-trace-node';
+import { traced } from '../../Core/tracing/traced';
+import { Ok, Err, Result } from '../../Core/result/result';
+
+describe('traced', () => {
+  const exporter = new InMemorySpanExporter();
+  const provider = new NodeTracerProvider();
+  provider.addSpanProcessor(new SimpleSpanProcessor(exporter));
+  provider.register({ contextManager: new AsyncLocalStorageContextManager() });
+
+  class DataSource {
+    @traced('DataSource.find')
+    async find(fail: boolean): Promise<Result<string, Error>> {
+      await new Promise((resolve) => setTimeout(resolve, 1));
+      return fail ? Err(new Error('not found')) : Ok('found');
+    }
+  }
+
+  class UseCase {
+    constructor(private dataSource: DataSource) {}
+
+    @traced('UseCase.execute')
+    async execute(fail: boolean): Promise<Result<string, Error>> {
+      return await this.dataSource.find(fail);
+    }
+  }
+
+  afterEach(() => exporter.reset());
+  afterAll(() => provider.shutdown());
+
+  it('should nest the inner span under the outer one across awaits', async () => {
+    await new UseCase(new DataSource()).execute(false);
+
+    const [inner, outer] = exporter.getFinishedSpans();
+    expect(outer.name).toBe('UseCase.execute');
+    expect(inner.name).toBe('DataSource.find');
+    expect(inner.parentSpanId).toBe(outer.spanContext().spanId);
+    expect(inner.spanContext().traceId).toBe(outer.spanContext().traceId);
+  });
+
+  it('should mark spans for Err results as failed', async () => {
+    await new UseCase(new DataSource()).execute(true);
+
+    const spans = exporter.getFinishedSpans();
+    expect(spans.map((span) => span.status.message)).toEqual(['not found', 'not found']);
+  });
+});
+EOL
+        echo "Created __tests__/Core/traced.test.ts"
+    fi
+
+    # Create Core/middleware/overload.ts
+    if [ "$PROTECT" = "true" ]; then
+        if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+            overload_import="import { FastifyReply, FastifyRequest } from 'fastify';"
+            overload_handlers="// onRequest hook for a feature plugin: answers 503 before the body is read when the process is overloaded
+export const shedLoad = async (request: FastifyRequest, reply: FastifyReply): Promise<FastifyReply | void> => {
+  const shedder = getShedder();
+  const reason = shedder.admit();
+  if (reason !== null) return reply.code(503).header('Retry-After', '1').send({ message: 'Server overloaded: ' + reason });
+  reply.raw.once('close', () => shedder.release());
+};
+
+// Route onRequest hook spending one token of the route's bucket for the client; 429 with Retry-After when it is empty
+export const rateLimit = (route: string) =>
+  async (request: FastifyRequest, reply: FastifyReply): Promise<FastifyReply | void> => {
+    const retryMs = limiterFor(route)?.take(clientKey(request.headers, request.ip)) ?? 0;
+    if (retryMs === 0) return;
+    return reply.code(429).header('Retry-After', String(Math.ceil(retryMs / 1000))).send({ message: 'Rate limit exceeded for ' + route });
+  };"
+        else
+            overload_import="import { Request, Response, NextFunction, RequestHandler } from 'express';
+import { Err } from '../result/result';
+import { CustomError } from '../error/custom-error';"
+            overload_handlers="// First middleware of a feature router: answers 503 before the body is read when the process is overloaded
+export const shedLoad = (req: Request, res: Response, next: NextFunction) => {
+  const shedder = getShedder();
+  const reason = shedder.admit();
+  if (reason !== null) {
+    res.set('Retry-After', '1');
+    return next(Err(new CustomError(503, 'Server overloaded: ' + reason)));
+  }
+  res.once('close', () => shedder.release());
+  next();
+};
+
+// Route middleware spending one token of the route's bucket for the client; 429 with Retry-After when it is empty
+export const rateLimit = (route: string): RequestHandler =>
+  (req: Request, res: Response, next: NextFunction) => {
+    const retryMs = limiterFor(route)?.take(clientKey(req.headers, req.ip)) ?? 0;
+    if (retryMs === 0) return next();
+    res.set('Retry-After', String(Math.ceil(retryMs / 1000)));
+    next(Err(new CustomError(429, 'Rate limit exceeded for ' + route)));
+  };"
+        fi
+        cat > Core/middleware/overload.ts << EOL
+$overload_import
+import { IncomingHttpHeaders } from 'node:http';
+import { monitorEventLoopDelay } from 'node:perf_hooks';
+
+// Token buckets, one per key: each holds up to burst tokens, refills at rate tokens per second, and a request
+// spends one. Map order doubles as recency, so past maxKeys the bucket used longest ago is dropped.
+export class RateLimiter {
+  private buckets = new Map<string, { tokens: number; refilled: number }>();
+
+  constructor(
+    private readonly rate: number,
+    private readonly burst: number,
+    private readonly maxKeys: number,
+  ) {}
+
+  // 0 when the request may go ahead, otherwise the milliseconds until the key's next token
+  take(key: string, now: number = Date.now()): number {
+    let bucket = this.buckets.get(key);
+    if (bucket) {
+      this.buckets.delete(key);
+      bucket.tokens = Math.min(this.burst, bucket.tokens + ((now - bucket.refilled) / 1000) * this.rate);
+      bucket.refilled = now;
+    } else {
+      bucket = { tokens: this.burst, refilled: now };
+      if (this.buckets.size >= this.maxKeys) this.buckets.delete(this.buckets.keys().next().value as string);
+    }
+    this.buckets.set(key, bucket);
+    if (bucket.tokens >= 1) {
+      bucket.tokens -= 1;
+      return 0;
+    }
+    return Math.ceil(((1 - bucket.tokens) / this.rate) * 1000);
+  }
+}
+
+// Concurrency-based load shedding: past maxInFlight requests in progress, or when the event loop's p99 delay over
+// the last sample exceeded maxLagMs, new requests are turned away at once instead of queueing behind slow ones.
+// A limit of 0 turns that check off.
+export class LoadShedder {
+  inFlight = 0;
+  lagMs = 0;
+
+  constructor(
+    private readonly maxInFlight: number,
+    private readonly maxLagMs: number,
+    sampleMs = 500,
+  ) {
+    if (maxLagMs > 0) {
+      const delay = monitorEventLoopDelay({ resolution: 10 });
+      delay.enable();
+      setInterval(() => {
+        this.lagMs = delay.percentile(99) / 1e6;
+        delay.reset();
+      }, sampleMs).unref();
+    }
+  }
+
+  // Why the request is shed, or null when it is admitted, in which case release() must follow once it is done
+  admit(): string | null {
+    if (this.maxInFlight > 0 && this.inFlight >= this.maxInFlight) return this.inFlight + ' requests in flight';
+    if (this.maxLagMs > 0 && this.lagMs > this.maxLagMs) return 'event loop lag ' + Math.round(this.lagMs) + 'ms';
+    this.inFlight++;
+    return null;
+  }
+
+  release(): void {
+    this.inFlight--;
+  }
+}
+
+// An unset variable takes the default; 0 is kept, and turns the limit off
+const envNumber = (name: string, defaultValue: number): number => {
+  const value = process.env[name];
+  return value === undefined || value === '' ? defaultValue : Number(value);
+};
+
+// Clients are told apart by RATE_LIMIT_KEY: ip, or the name of a header such as x-api-key (falling back to the ip)
+export const clientKey = (headers: IncomingHttpHeaders, ip: string | undefined): string => {
+  const keyHeader = (process.env.RATE_LIMIT_KEY || 'ip').toLowerCase();
+  const value = keyHeader === 'ip' ? undefined : headers[keyHeader];
+  return (Array.isArray(value) ? value[0] : value) || ip || 'unknown';
+};
+
+// One limiter per route, built on first use (after dotenv). RATE_LIMIT_RPS and RATE_LIMIT_BURST apply to every route;
+// RATE_LIMIT_<ROUTE>_RPS and RATE_LIMIT_<ROUTE>_BURST (e.g. RATE_LIMIT_ORDERS_BULK_RPS for orders.bulk) override them
+const limiters = new Map<string, RateLimiter | null>();
+const limiterFor = (route: string): RateLimiter | null => {
+  let limiter = limiters.get(route);
+  if (limiter === undefined) {
+    const prefix = 'RATE_LIMIT_' + route.toUpperCase().replace(/[^A-Z0-9]+/g, '_') + '_';
+    const rate = envNumber(prefix + 'RPS', envNumber('RATE_LIMIT_RPS', 100));
+    const burst = envNumber(prefix + 'BURST', envNumber('RATE_LIMIT_BURST', rate * 2));
+    limiter = rate > 0 ? new RateLimiter(rate, Math.max(burst, 1), envNumber('RATE_LIMIT_MAX_KEYS', 10000)) : null;
+    limiters.set(route, limiter);
+  }
+  return limiter;
+};
+
+// One shedder for the process, so every feature counts against the same in-flight limit
+let processShedder: LoadShedder | null = null;
+const getShedder = (): LoadShedder =>
+  (processShedder ??= new LoadShedder(envNumber('SHED_MAX_IN_FLIGHT', 512), envNumber('SHED_MAX_EVENT_LOOP_LAG_MS', 200)));
+
+$overload_handlers
+EOL
+        echo "Created Core/middleware/overload.ts"
+
+        # Create __tests__/Core/overload.test.ts
+        cat > __tests__/Core/overload.test.ts << EOL
+import { RateLimiter, LoadShedder, clientKey } from '../../Core/middleware/overload';
+
+describe('RateLimiter', () => {
+  it('should allow a burst, then refill at the configured rate', () => {
+    const limiter = new RateLimiter(10, 2, 100);
+
+    expect(limiter.take('client', 0)).toBe(0);
+    expect(limiter.take('client', 0)).toBe(0);
+    expect(limiter.take('client', 0)).toBe(100);
+    expect(limiter.take('other', 0)).toBe(0);
+    expect(limiter.take('client', 100)).toBe(0);
+  });
+
+  it('should drop the least recently used bucket past maxKeys', () => {
+    const limiter = new RateLimiter(1, 1, 2);
+    limiter.take('a', 0);
+    limiter.take('b', 0);
+    limiter.take('c', 0);
+
+    expect(limiter.take('a', 0)).toBe(0);
+    expect(limiter.take('c', 0)).toBeGreaterThan(0);
+  });
+});
+
+describe('LoadShedder', () => {
+  it('should shed past the in-flight limit until requests are released', () => {
+    const shedder = new LoadShedder(1, 0);
+
+    expect(shedder.admit()).toBeNull();
+    expect(shedder.admit()).toContain('in flight');
+    shedder.release();
+    expect(shedder.admit()).toBeNull();
+  });
+
+  it('should shed while the event loop lags', () => {
+    const shedder = new LoadShedder(0, 100);
+    shedder.lagMs = 250;
+
+    expect(shedder.admit()).toBe('event loop lag 250ms');
+  });
+});
+
+describe('clientKey', () => {
+  afterEach(() => delete process.env.RATE_LIMIT_KEY);
+
+  it('should key by ip unless RATE_LIMIT_KEY names a header', () => {
+    expect(clientKey({ 'x-api-key': 'k1' }, '10.0.0.1')).toBe('10.0.0.1');
+    process.env.RATE_LIMIT_KEY = 'X-Api-Key';
+    expect(clientKey({ 'x-api-key': 'k1' }, '10.0.0.1')).toBe('k1');
+    expect(clientKey({}, '10.0.0.1')).toBe('10.0.0.1');
+  });
+});
+EOL
+        echo "Created __tests__/Core/overload.test.ts"
+    fi
+fi
+
+phase_done "project"
+
+# Create Core/http/shutdown.ts (also for projects generated before it, or its stop hooks, existed), which Server/index.ts imports
+if [ "$COMMAND" != "feature" ] || ! grep -q "stopJobs" Core/http/shutdown.ts 2> /dev/null; then
+    mkdir -p Core/http
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        shutdown_import="import { FastifyInstance } from 'fastify';"
+        shutdown_target="app: FastifyInstance"
+        shutdown_server="app.server"
+        stop_server="// Fastify stops listening, closes idle keep-alive sockets, answers requests that still arrive on busy ones with
+// 503 and Connection: close, and resolves once the in-flight requests have been answered
+const stopServer = (app: FastifyInstance): Promise<void> => app.close();"
+        stop_call="stopServer(app)"
+    else
+        shutdown_import="import { Server } from 'node:http';"
+        shutdown_target="server: Server"
+        shutdown_server="server"
+        stop_server="// Stops listening and resolves once every connection has closed. Idle keep-alive sockets would hold that off, so
+// they are closed now and again as in-flight requests finish, and requests still arriving on them get Connection: close.
+const stopServer = (server: Server): Promise<void> =>
+  new Promise((resolve, reject) => {
+    const sweep = setInterval(() => server.closeIdleConnections(), 100);
+    server.prependListener('request', (req, res) => res.setHeader('Connection', 'close'));
+    server.close((error) => {
+      clearInterval(sweep);
+      if (error) reject(error);
+      else resolve();
+    });
+    server.closeIdleConnections();
+  });"
+        stop_call="stopServer(server)"
+    fi
+    if [ "$TRACING" = "true" ]; then
+        tracing_flush_import="
+import { shutdownTracing } from '../tracing/tracing';"
+        # Projects generated before Core/tracing exported it get the flush appended
+        if ! grep -q "shutdownTracing" Core/tracing/tracing.ts 2> /dev/null; then
+            printf '\n%s\n%s\n' "// Flushes buffered spans and stops exporting; called by Core/http/shutdown.ts once requests have drained" \
+                "export const shutdownTracing = (): Promise<void> => provider.shutdown();" >> Core/tracing/tracing.ts
+        fi
+        flush_tracing="
+      // Export the spans still buffered in the batch processor, including those of the drained requests
+      await shutdownTracing();"
+        flush_note="
+// Spans still buffered are exported last."
+    else
+        tracing_flush_import=""
+        flush_tracing=""
+        flush_note=""
+    fi
+    cat > Core/http/shutdown.ts << EOL
+$shutdown_import
+import mongoose from 'mongoose';$tracing_flush_import
+
+let shuttingDown = false;
+
+// True from the first SIGTERM or SIGINT on; /health/ready then answers 503 so load balancers stop routing here
+export const isShuttingDown = (): boolean => shuttingDown;
+
+$stop_server
+
+// Drains the process on SIGTERM (a rolling deploy) or SIGINT instead of dropping what is in flight: the server stops
+// accepting connections and in-flight requests get SHUTDOWN_TIMEOUT_MS (default 10000) to finish before the sockets
+// still open are destroyed. Then stopJobs (the outbox relay, read model projectors) stop their loops, change streams
+// and timers, and only after that is the Mongoose pool closed, so neither requests nor jobs lose MongoDB midway.$flush_note
+export const drainOnShutdown = ($shutdown_target, stopJobs: (() => Promise<void>)[] = []): void => {
+  const shutdown = async (signal: NodeJS.Signals) => {
+    if (shuttingDown) return;
+    shuttingDown = true;
+    const timeoutMs = Number(process.env.SHUTDOWN_TIMEOUT_MS) || 10000;
+    console.log(signal + ' received: draining in-flight requests for up to ' + timeoutMs + 'ms');
+    const deadline = setTimeout(() => {
+      console.warn('Shutdown deadline passed: closing the remaining connections');
+      $shutdown_server.closeAllConnections();
+      // Exit even if something still holds the process open once the sockets are gone
+      setTimeout(() => process.exit(1), 1000).unref();
+    }, timeoutMs);
+    let exitCode = 0;
+    try {
+      await $stop_call;
+      await Promise.all(stopJobs.map((stop) => stop()));
+      await mongoose.disconnect();$flush_tracing
+    } catch (error) {
+      console.error('Graceful shutdown failed:', error);
+      exitCode = 1;
+    } finally {
+      clearTimeout(deadline);
+    }
+    process.exit(exitCode);
+  };
+  process.once('SIGTERM', shutdown);
+  process.once('SIGINT', shutdown);
+};
+EOL
+    echo "Created Core/http/shutdown.ts"
+fi
+
+# Generate or update Server/index.ts, wiring every feature already in the project plus the new ones
+SERVER_FEATURES=()
+for container_file in Features/*/container.ts; do
+    [ -f "$container_file" ] || continue
+    feature="${container_file#Features/}"
+    SERVER_FEATURES+=("${feature%/container.ts}")
+done
+for feature in "${FEATURES[@]}"; do
+    [[ " ${SERVER_FEATURES[*]} " == *" $feature "* ]] || SERVER_FEATURES+=("$feature")
+done
+# Read models, whose projectors start with the server
+READ_MODELS=()
+for feature in "${SERVER_FEATURES[@]}"; do
+    if [ -f "Features/$feature/data/projections/$feature.projection.ts" ]; then
+        READ_MODELS+=("$feature")
+        continue
+    fi
+    for i in "${!FEATURES[@]}"; do
+        [ "${FEATURES[$i]}" = "$feature" ] && [ "${KINDS[$i]}" = "readmodel" ] && READ_MODELS+=("$feature")
+    done
+done
+# Background jobs hand drainOnShutdown their stop hooks
+if [ ${#READ_MODELS[@]} -gt 0 ] || [ "$USES_OUTBOX" = "true" ]; then
+    shutdown_jobs=", stopJobs"
+else
+    shutdown_jobs=""
+fi
+if [ "$CLUSTER" = "true" ]; then
+    server_imports="
+import cluster from 'node:cluster';
+import os from 'node:os';"
+    background_jobs=()
+    [ ${#READ_MODELS[@]} -gt 0 ] && background_jobs+=(READMODEL_REFRESH)
+    [ "$USES_OUTBOX" = "true" ] && background_jobs+=(OUTBOX_RELAY)
+    if [ ${#background_jobs[@]} -gt 0 ]; then
+        printf -v follower_env "%s: 'off', " "${background_jobs[@]}"
+        job_names="${background_jobs[*]}"
+        cluster_forks="// Only the first worker runs MONGO_SYNC_INDEXES so the workers don't race on index builds, and one worker at a
+  // time runs the background jobs (${job_names// /, }), handing them to its replacement if it exits
+  const followerEnv = { MONGO_SYNC_INDEXES: 'false', ${follower_env%, } };
+  let leader = 0;
+  for (let index = 0; index < workerCount; index++) {
+    const worker = cluster.fork(index === 0 ? {} : followerEnv);
+    if (index === 0) leader = worker.id;
+  }"
+        cluster_refork="const leads = worker.id === leader;
+      const replacement = cluster.fork(leads ? { MONGO_SYNC_INDEXES: 'false' } : followerEnv);
+      if (leads) leader = replacement.id;"
+    else
+        cluster_forks="// Only the first worker runs MONGO_SYNC_INDEXES so the workers don't race on index builds
+  for (let index = 0; index < workerCount; index++) {
+    cluster.fork(index === 0 ? {} : { MONGO_SYNC_INDEXES: 'false' });
+  }"
+        cluster_refork="cluster.fork({ MONGO_SYNC_INDEXES: 'false' });"
+    fi
+    server_bootstrap="// CLUSTER_WORKERS=0 starts one worker per core; the workers share the listening port
+const startCluster = () => {
+  const workerCount = Number(process.env.CLUSTER_WORKERS) || os.availableParallelism();
+  let shuttingDown = false;
+  $cluster_forks
+  // Replacements back off exponentially (up to 30s), and the primary gives up once more than CLUSTER_MAX_RESTARTS
+  // workers exited within CLUSTER_RESTART_WINDOW_MS, so an outage (e.g. MongoDB down) is not a crash loop on every core
+  const maxRestarts = Number(process.env.CLUSTER_MAX_RESTARTS) || 10;
+  const restartWindowMs = Number(process.env.CLUSTER_RESTART_WINDOW_MS) || 60000;
+  let exits: number[] = [];
+  cluster.on('exit', (worker, code, signal) => {
+    if (shuttingDown) return;
+    const now = Date.now();
+    exits = exits.filter((at) => now - at < restartWindowMs).concat(now);
+    if (exits.length > maxRestarts) {
+      console.error(\`\${exits.length} workers exited within \${restartWindowMs}ms; stopping\`);
+      shuttingDown = true;
+      for (const other of Object.values(cluster.workers ?? {})) other?.process.kill('SIGTERM');
+      process.exitCode = 1;
+      return;
+    }
+    const delayMs = Math.min(30000, 100 * 2 ** (exits.length - 1));
+    console.warn(\`Worker \${worker.process.pid} exited (\${signal || code}); starting a replacement in \${delayMs}ms\`);
+    setTimeout(() => {
+      if (shuttingDown) return;
+      $cluster_refork
+    }, delayMs);
+  });
+  process.on('SIGTERM', () => {
+    shuttingDown = true;
+    for (const worker of Object.values(cluster.workers ?? {})) {
+      worker?.process.kill('SIGTERM');
+    }
+  });
+  console.log(\`Primary \${process.pid} started \${workerCount} workers\`);
+};
+
+if (cluster.isPrimary) {
+  startCluster();
+} else {
+  startServer();
+}"
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        server_listen="await app.listen({ port, host: '0.0.0.0' });
+    console.log(\`Worker \${process.pid} listening on http://localhost:\${port}\`);
+    drainOnShutdown(app$shutdown_jobs);"
+    else
+        server_listen="const server = app.listen(port, () => {
+      console.log(\`Worker \${process.pid} listening on http://localhost:\${port}\`);
+    });
+    drainOnShutdown(server$shutdown_jobs);"
+    fi
+elif [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+    server_imports=""
+    server_bootstrap="startServer();"
+    server_listen="await app.listen({ port, host: '0.0.0.0' });
+    console.log(\`Server running on http://localhost:\${port}\`);
+    drainOnShutdown(app$shutdown_jobs);"
+else
+    server_imports=""
+    server_bootstrap="startServer();"
+    server_listen="const server = app.listen(port, () => {
+      console.log(\`Server running on http://localhost:\${port}\`);
+    });
+    drainOnShutdown(server$shutdown_jobs);"
+fi
+if [ "$PERF" = "true" ]; then
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        server_imports+="
+import compress from '@fastify/compress';
+import etag from '@fastify/etag';"
+        perf_middleware="
+// Compress bodies above COMPRESSION_THRESHOLD bytes; weak ETags let GET routes answer If-None-Match with 304
+app.register(compress, { threshold: Number(process.env.COMPRESSION_THRESHOLD) || 1024 });
+app.register(etag, { weak: true });"
+        http_server="app.server"
+    else
+        server_imports+="
+import compression from 'compression';"
+        perf_middleware="
+// Compress bodies above COMPRESSION_THRESHOLD bytes; weak ETags let GET routes answer If-None-Match with 304
+app.use(compression({ threshold: Number(process.env.COMPRESSION_THRESHOLD) || 1024 }));
+app.set('etag', 'weak');"
+        http_server="server"
+    fi
+    server_listen="$server_listen
+    // Keep idle connections open longer than the load balancer does (60s on most), so it never reuses a closed socket
+    $http_server.keepAliveTimeout = Number(process.env.KEEP_ALIVE_TIMEOUT_MS) || 65000;
+    $http_server.headersTimeout = Number(process.env.HEADERS_TIMEOUT_MS) || $http_server.keepAliveTimeout + 1000;
+    $http_server.requestTimeout = Number(process.env.REQUEST_TIMEOUT_MS) || 30000;"
+else
+    perf_middleware=""
+fi
+if [ "$METRICS" = "true" ]; then
+    server_imports+="
+import { collectRuntimeMetrics } from '../Core/metrics/metrics';
+import { metricsRouter } from '../Core/metrics/metrics.router';"
+fi
+if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+    server_app="import Fastify from 'fastify';"
+    server_setup="const app = Fastify();
+const port = Number(process.env.PORT) || 3000;
+
+// Routes validate their bodies and serialize their responses with the JSON schemas in delivery/schemas
+app.setErrorHandler(errorHandler);$perf_middleware
+app.register(healthRouter, { prefix: '/health' });$(
+[ "$METRICS" = "true" ] && printf "\ncollectRuntimeMetrics();\napp.register(metricsRouter, { prefix: '/metrics' });"
+)
+$(for feature in "${SERVER_FEATURES[@]}"; do
+    capitalize_into Feature "$feature"
+    echo "app.register(container.resolve(${Feature}Controller).routes, { prefix: '/api/$feature' });"
+done)"
+else
+    server_app="import express from 'express';"
+    server_setup="const app = express();
+const port = process.env.PORT || 3000;
+
+// No global body parser: each route parses its own body with its own size limit (Core/http/body.ts)$perf_middleware
+app.use('/health', healthRouter);$(
+[ "$METRICS" = "true" ] && printf "\ncollectRuntimeMetrics();\napp.use('/metrics', metricsRouter);"
+)
+$(for feature in "${SERVER_FEATURES[@]}"; do
+    capitalize_into Feature "$feature"
+    if [ "$DI_SCOPE" = "request" ]; then
+        echo "app.use('/api/$feature', (req, res, next) => container.createChildContainer().resolve(${Feature}Controller).getRouter()(req, res, next));"
+    else
+        echo "const ${feature}Controller = container.resolve(${Feature}Controller);"
+        echo "app.use('/api/$feature', ${feature}Controller.getRouter());"
+    fi
+done)
+app.use(errorHandler);"
+fi
+[ "$TRACING" = "true" ] && server_imports="
+import '../Core/tracing/tracing';$server_imports"
+# Background jobs, started once the database is connected: read model projectors and the outbox relay
+background_start=""
+if [ ${#READ_MODELS[@]} -gt 0 ]; then
+    background_start="
+    if (process.env.READMODEL_REFRESH !== 'off') {"
+    for feature in "${READ_MODELS[@]}"; do
+        capitalize_into Feature "$feature"
+        # Projectors generated before start() returned a stop hook are only started
+        if [ -f "Features/$feature/data/projections/$feature.projection.ts" ] &&
+            ! grep -q "stop()" "Features/$feature/data/projections/$feature.projection.ts"; then
+            background_start+="
+      container.resolve(${Feature}Projector).start();"
+        else
+            background_start+="
+      stopJobs.push(container.resolve(${Feature}Projector).start());"
+        fi
+    done
+    background_start+="
+    }"
+fi
+if [ "$USES_OUTBOX" = "true" ]; then
+    server_imports+="
+import { startOutboxRelay } from '../Core/outbox/relay';"
+    if [ -f Core/outbox/relay.ts ] && ! grep -q "stop()" Core/outbox/relay.ts; then
+        background_start+="
+    if (process.env.OUTBOX_RELAY !== 'off') startOutboxRelay();"
+    else
+        background_start+="
+    if (process.env.OUTBOX_RELAY !== 'off') stopJobs.push(startOutboxRelay());"
+    fi
+fi
+if [ -n "$background_start" ]; then
+    background_start="
+    // Stopped by drainOnShutdown before the MongoDB connection closes
+    const stopJobs: (() => Promise<void>)[] = [];$background_start"
+fi
+server_content="import 'reflect-metadata';${server_imports}
+$server_app
+import dotenv from 'dotenv';
+import { container } from 'tsyringe';
+import { connectToDatabase } from '../Core/config/database';
+import { errorHandler } from '../Core/error/error-handler';
+import { healthRouter } from '../Core/health/health.router';
+import { drainOnShutdown } from '../Core/http/shutdown';
+$(for feature in "${SERVER_FEATURES[@]}"; do
+    capitalize_into Feature "$feature"
+    echo "import '../Features/$feature/container';"
+    echo "import { ${Feature}Controller } from '../Features/$feature/delivery/controllers/$feature.controller';"
+done)$(for feature in "${READ_MODELS[@]}"; do
+    capitalize_into Feature "$feature"
+    printf "\nimport { %sProjector } from '../Features/%s/data/projections/%s.projection';" "$Feature" "$feature" "$feature"
+done)
+
+dotenv.config();
+
+$server_setup
+
+const startServer = async () => {
+  try {
+    await connectToDatabase();$background_start
+    $server_listen
+  } catch (error) {
+    // Exit so the process supervisor (or the cluster primary, with backoff) decides whether to start it again
+    console.error('Failed to start server:', error);
+    process.exit(1);
+  }
+};
+
+$server_bootstrap"
+echo "$server_content" > Server/index.ts
+echo "Created/Updated Server/index.ts"
+
+# Generate or update Server/lambda.ts (--target lambda), serving every CRUD feature through its
+# delivery/handlers adapter. Read models stay on Server/index.ts, which runs their projectors.
+if [ "$TARGET" != "server" ]; then
+    HANDLER_FEATURES=()
+    for feature in "${SERVER_FEATURES[@]}"; do
+        [[ " ${READ_MODELS[*]} " == *" $feature "* ]] || HANDLER_FEATURES+=("$feature")
+    done
+    handler_imports=""
+    handler_entries=""
+    handler_scope="container"
+    [ "$DI_SCOPE" = "request" ] && handler_scope="scope"
+    for feature in "${HANDLER_FEATURES[@]}"; do
+        capitalize_into Feature "$feature"
+        handler_imports+="
+import '../Features/$feature/container';
+import { ${Feature}Handler } from '../Features/$feature/delivery/handlers/$feature.handler';"
+        handler_entries+="
+    ['$feature', $handler_scope.resolve(${Feature}Handler)],"
+    done
+    if [ "$DI_SCOPE" = "request" ]; then
+        feature_handlers="// --di-scope request: a child container per invocation, as Server/index.ts creates one per HTTP request
+const featureHandlers = (): Map<string, FeatureHandler> => {
+  const scope = container.createChildContainer();
+  return new Map<string, FeatureHandler>([${handler_entries}
+  ]);
+};"
+    else
+        feature_handlers="// The DI graph is built on the first invocation of each cold start, once the environment is loaded, and reused
+// by every invocation the instance serves after it
+let handlers: Map<string, FeatureHandler> | null = null;
+const featureHandlers = (): Map<string, FeatureHandler> =>
+  (handlers ??= new Map<string, FeatureHandler>([${handler_entries}
+  ]));"
+    fi
+    entry_content="import 'reflect-metadata';$([ "$TRACING" = "true" ] && printf "\nimport '../Core/tracing/tracing';")
+import dotenv from 'dotenv';
+import type { APIGatewayProxyEventV2, APIGatewayProxyStructuredResultV2, Context } from 'aws-lambda';
+import { container } from 'tsyringe';
+import { ensureDatabase } from '../Core/serverless/connection';
+import { dispatch, FeatureHandler, HttpRequest } from '../Core/serverless/http';${handler_imports}
+
+dotenv.config();
+
+$feature_handlers
+
+// API Gateway HTTP API (payload format 2.0) and Lambda function URL events
+const toHttpRequest = (event: APIGatewayProxyEventV2): HttpRequest => ({
+  method: event.requestContext.http.method,
+  path: event.rawPath,
+  query: event.queryStringParameters ?? {},
+  headers: event.headers ?? {},
+  body: event.body === undefined ? '' : event.isBase64Encoded ? Buffer.from(event.body, 'base64').toString('utf8') : event.body,
+});
+
+// The function handler (dist/Server/lambda.handler)
+export const handler = async (event: APIGatewayProxyEventV2, context: Context): Promise<APIGatewayProxyStructuredResultV2> => {
+  // Respond as soon as the handler returns instead of waiting for the pooled MongoDB sockets to close
+  context.callbackWaitsForEmptyEventLoop = false;
+  await ensureDatabase();
+  return await dispatch(featureHandlers(), toHttpRequest(event));
+};"
+    echo "$entry_content" > "$SERVER_ENTRY"
+    echo "Created/Updated $SERVER_ENTRY"
+fi
+phase_done "server"
+
+# Generate feature-specific files; generate_feature writes everything for FEATURES[$i]
+sample_jsons=()
+# Function to write the files of read model FEATURES[$i] (--kind readmodel): a collection of rows precomputed from
+# SOURCES[$i] by an aggregation pipeline, a projector that keeps it current, and query/refresh use cases. Non-number
+# --fields are the group keys, typed as the source field they copy; number fields are totals of the source field of
+# the same name.
+generate_readmodel() {
+    local source="${SOURCES[$i]}" Source keys=() key_types=() totals=() j name ts_type mongoose_type value key_type
+    capitalize_into Source "$source"
+    parse_fields "$fields"
+    for j in "${!field_names[@]}"; do
+        if [ "${field_types[$j]}" = "number" ]; then
+            totals+=("${field_names[$j]}")
+        else
+            keys+=("${field_names[$j]}")
+            source_field_type key_type "$source" "${field_names[$j]}"
+            key_types+=("$key_type")
+        fi
+    done
+    sample_jsons[$i]=""
+    if [ "${REGENERATE[$i]}" = "false" ]; then
+        echo "Unchanged since the last apply: $feature"
+        return 0
+    fi
+
+    entity_params=""
+    model_types=""
+    model_fields=""
+    schema_indexes=""
+    doc_args=""
+    sample_args=""
+    key_list=""
+    key_union=""
+    set_keys=""
+    express_filters=""
+    fastify_filters=""
+    query_properties=""
+    query_value_parser=""
+    filter_sample=""
+    for j in "${!keys[@]}"; do
+        name="${keys[$j]}"
+        to_ts_type ts_type "${key_types[$j]}"
+        to_mongoose_type mongoose_type "${key_types[$j]}"
+        [ "$mongoose_type" = "Mixed" ] && mongoose_type="Schema.Types.Mixed"
+        case "${key_types[$j]}" in
+            string) value="'sample_$name'" ;;
+            number) value="1" ;;
+            boolean) value="true" ;;
+            *) value="null" ;;
+        esac
+        entity_params+="public $name: $ts_type,"$'\n'"    "
+        model_types+="$name: $ts_type;"$'\n'"  "
+        model_fields+="$name: { type: $mongoose_type },"$'\n'"    "
+        schema_indexes+="${Feature}Schema.index({ $name: 1, _id: 1 });"$'\n'
+        doc_args+="doc.$name, "
+        sample_args+="$value, "
+        key_list+="'$name', "
+        key_union+="'$name' | "
+        filter_sample+="$name: $value, "
+        if [ ${#keys[@]} -eq 1 ]; then
+            set_keys+="$name: '\$_id', "
+        else
+            set_keys+="$name: '\$_id.$name', "
+        fi
+        # Query values are strings: each is cast to the key's type, or the filter would never match a stored value
+        case "${key_types[$j]}" in
+            string)
+                express_filters+=$'\n'"    if (typeof req.query.$name === 'string') filter.$name = req.query.$name;"
+                query_properties+="$name: { type: 'string' }, "
+                ;;
+            number)
+                express_filters+=$'\n'"    if (typeof req.query.$name === 'string') filter.$name = Number(req.query.$name);"
+                query_properties+="$name: { type: 'number' }, "
+                ;;
+            boolean)
+                express_filters+=$'\n'"    if (typeof req.query.$name === 'string') filter.$name = req.query.$name === 'true';"
+                query_properties+="$name: { type: 'boolean' }, "
+                ;;
+            *)
+                express_filters+=$'\n'"    if (typeof req.query.$name === 'string') filter.$name = parseQueryValue(req.query.$name);"
+                fastify_filters+=$'\n'"    if (typeof filter.$name === 'string') filter.$name = parseQueryValue(filter.$name);"
+                query_properties+="$name: { type: 'string' }, "
+                query_value_parser="
+
+// A key of any other type is matched as the JSON in the query value (?$name=42, ?$name={\"a\":1}), or else as the string
+const parseQueryValue = (value: string): unknown => {
+  try {
+    return JSON.parse(value);
+  } catch {
+    return value;
+  }
+};"
+                ;;
+        esac
+    done
+    entity_params+="public count: number,"
+    model_types+="count: number;"
+    model_fields+="count: { type: Number, required: true },"
+    doc_args+="doc.count, "
+    sample_args+="2, "
+    group_totals=""
+    for name in "${totals[@]}"; do
+        entity_params+=$'\n'"    public $name: number,"
+        model_types+=$'\n'"  $name: number;"
+        model_fields+=$'\n'"    $name: { type: Number, required: true },"
+        doc_args+="doc.$name, "
+        sample_args+="246, "
+        group_totals+=", $name: { \$sum: '\$$name' }"
+    done
+    [ -n "$schema_indexes" ] && schema_indexes=$'\n'"$schema_indexes"
+    key_list="${key_list%, }"
+    key_union="${key_union% | }"
+    filter_sample="${filter_sample%, }"
+    case ${#keys[@]} in
+        0)
+            group_id="null"
+            key_of="null"
+            match_of="({})"
+            key_union="never"
+            filter_sample="{}"
+            match_example="{}"
+            query_comment=""
+            ;;
+        1)
+            group_id="'\$${keys[0]}'"
+            key_of="doc.${keys[0]} ?? null"
+            match_of="({ ${keys[0]}: key })"
+            filter_sample="{ $filter_sample }"
+            match_example="$filter_sample"
+            ;;
+        *)
+            group_id="{ "
+            key_of="({ "
+            for name in "${keys[@]}"; do
+                group_id+="$name: '\$$name', "
+                key_of+="$name: doc.$name, "
+            done
+            group_id="${group_id%, } }"
+            key_of="${key_of%, } })"
+            match_of="key as Record<string, unknown>"
+            filter_sample="{ $filter_sample }"
+            match_example="$filter_sample"
+            ;;
+    esac
+    if [ ${#keys[@]} -gt 0 ]; then
+        query_comment="
+  // GET / pages through the precomputed rows, optionally filtered by group key (?${keys[0]}=...)"
+    fi
+    if [ "$DI_SCOPE" = "request" ]; then
+        tsyringe_imports="container, Lifecycle"
+    else
+        tsyringe_imports="container"
+    fi
+
+    mkdir -p "Features/$feature/domain/entity" "Features/$feature/domain/usecases" "Features/$feature/domain/repositories"
+    mkdir -p "Features/$feature/data/repositories" "Features/$feature/data/datasources" "Features/$feature/data/models"
+    mkdir -p "Features/$feature/data/projections" "Features/$feature/delivery/controllers" "__tests__/Features/$feature"
+    echo "Created folder structure for read model: $feature (from $source)"
+
+    render_template "Features/$feature/container.ts" readmodel.container.ts
+    echo "Created Features/$feature/container.ts"
+    render_template "Features/$feature/domain/entity/$feature.entity.ts" readmodel.entity.ts
+    echo "Created Features/$feature/domain/entity/$feature.entity.ts"
+    render_template "Features/$feature/domain/repositories/$feature.repository.interface.ts" readmodel.repository.interface.ts
+    echo "Created Features/$feature/domain/repositories/$feature.repository.interface.ts"
+    render_template "Features/$feature/domain/usecases/query-$feature.usecase.ts" readmodel.query.usecase.ts
+    echo "Created Features/$feature/domain/usecases/query-$feature.usecase.ts"
+    render_template "Features/$feature/domain/usecases/refresh-$feature.usecase.ts" readmodel.refresh.usecase.ts
+    echo "Created Features/$feature/domain/usecases/refresh-$feature.usecase.ts"
+    render_template "Features/$feature/data/models/$feature.model.ts" readmodel.model.ts
+    echo "Created Features/$feature/data/models/$feature.model.ts"
+    render_template "Features/$feature/data/projections/$feature.projection.ts" readmodel.projection.ts
+    echo "Created Features/$feature/data/projections/$feature.projection.ts"
+    render_template "Features/$feature/data/datasources/$feature.datasource.ts" readmodel.datasource.ts
+    echo "Created Features/$feature/data/datasources/$feature.datasource.ts"
+    render_template "Features/$feature/data/repositories/$feature.repository.ts" readmodel.repository.ts
+    echo "Created Features/$feature/data/repositories/$feature.repository.ts"
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        render_template "Features/$feature/delivery/controllers/$feature.controller.ts" readmodel.controller.fastify.ts
+    else
+        render_template "Features/$feature/delivery/controllers/$feature.controller.ts" readmodel.controller.express.ts
+    fi
+    echo "Created Features/$feature/delivery/controllers/$feature.controller.ts"
+    render_template "__tests__/Features/$feature/$feature.readmodel.test.ts" readmodel.test.ts
+    echo "Created __tests__/Features/$feature/$feature.readmodel.test.ts"
+}
+
+generate_feature() {
+    feature="${FEATURES[$i]}"
+    fields="${FIELD_DEFS[$i]}"
+    capitalize_into Feature "$feature"
+    if [ "${KINDS[$i]}" = "readmodel" ]; then
+        generate_readmodel
+        return
+    fi
+
+    # Default fields if none provided
+    if [ -z "$fields" ]; then
+        fields="name:string:minlength=3,email:string:email"
+    fi
+
+    # Parse fields
+    parse_fields "$fields"
+    entity_fields=""
+    entity_params=""
+    if [ "${ID_FIELDS[$i]}" = "_id" ]; then
+        projection_fields="_id: 1, "
+    else
+        projection_fields="_id: 0, id: 1, "
+    fi
+    dto_fields=""
+    model_fields=""
+    # Constructor argument lists, built here once instead of piping through tr in every template
+    dto_args=""
+    dto_props=""
+    doc_args=""
+    feature_doc_args=""
+    raw_args=""
+    for j in "${!field_names[@]}"; do
+        name="${field_names[$j]}"
+        type="${field_types[$j]}"
+        rule="${field_rules[$j]}"
+        to_ts_type ts_type "$type"
+        to_mongoose_type mongoose_type "$type"
+        dto_args+="dto.$name, "
+        dto_props+="$name: dto.$name, "
+        doc_args+="doc.$name, "
+        feature_doc_args+="${feature}Doc.$name, "
+        raw_args+="raw.$name, "
+        entity_fields+="$name: $ts_type; "
+        entity_params+="public $name: $ts_type,"$'\n'"    "
+        projection_fields+="$name: 1, "
+        dto_fields+="$name: $ts_type;"$'\n'"  "
+        model_fields+="$name: { type: $mongoose_type, required: true },"$'\n'"  "
+    done
+    entity_fields="${entity_fields%; }"
+    entity_params="${entity_params%,$'\n'    }"
+    projection_fields+="version: 1"
+    dto_fields="${dto_fields%$'\n'  }"
+    model_fields="${model_fields%$'\n'  }"
+    raw_args="${raw_args%, }"
+    dto_args="${dto_args%, }"
+    doc_args="${doc_args%, }"
+    feature_doc_args="${feature_doc_args%, }"
+    get_sample_json
+    sample_jsons[$i]="{$sample_json}"
+    sample="${sample_jsons[$i]}"
+    valid_payload="${sample_json:+{$sample_json\}}"
+    if [ "${REGENERATE[$i]}" = "false" ]; then
+        echo "Unchanged since the last apply: $feature"
+        return 0
+    fi
+    get_zod_schema field_names[@] field_types[@] field_rules[@]
+    get_inline_validator
+    if [ "$inline_needs_email" = "true" ]; then
+        email_pattern=$'\n'"const EMAIL_PATTERN = /^[^\\s@]+@[^\\s@]+\\.[^\\s@]+\$/;"$'\n'
+    else
+        email_pattern=""
+    fi
+    get_schema_indexes "${Feature}Schema" "${INDEX_DEFS[$i]}"
+    get_serializer
+    get_json_schema
+
+    # Keyset pagination: _id alone, or (field, _id) so rows with equal field values still have a strict order
+    page_key="${PAGE_KEYS[$i]}"
+    if [ "$page_key" = "_id" ]; then
+        page_filter="after ? { _id: { \$gt: after.id } } : {}"
+        page_sort="{ _id: 1 }"
+        page_next="{ id: String(last._id) }"
+    else
+        if [[ " ${field_names[*]} " != *" $page_key "* ]]; then
+            echo "Error: --page-by references unknown field '$page_key'"
+            exit 1
+        fi
+        page_filter="after ? { \$or: [{ $page_key: { \$gt: after.key } }, { $page_key: after.key, _id: { \$gt: after.id } }] } : {}"
+        page_sort="{ $page_key: 1, _id: 1 }"
+        page_next="{ key: last.$page_key, id: String(last._id) }"
+        schema_indexes="${schema_indexes:-$'\n'}${Feature}Schema.index({ $page_key: 1, _id: 1 });"$'\n'
+    fi
+
+    # Read path: hydrated documents by default, lean projected reads with --lean-reads. With --replica-reads,
+    # findById and findPage go where Core/config/replica-reads.ts says, while writes stay on the primary.
+    if [ "${REPLICA_READS[$i]}" = "true" ]; then
+        replica_import=$'\n'"import { replicaReads } from '../../../../Core/config/replica-reads';"
+        replica_read=".read(replicaReads('$feature'))"
+        page_read=$'\n'"        $replica_read"
+    else
+        replica_import=""
+        replica_read=""
+        page_read=""
+    fi
+    if [ "${LEAN_READS[$i]}" = "true" ]; then
+        find_by_id_query="
+      // lean() skips document hydration and the projection limits what the server sends back
+      const ${feature}Doc = await ${Feature}Model.findOne({ id }, ${feature}Projection)$replica_read.lean<${Feature}Record>();"
+    else
+        find_by_id_query="
+      const ${feature}Doc = await ${Feature}Model.findOne({ id })$replica_read;"
+    fi
+
+    # Identity: a separate unique "id" column by default, or the entity id stored as _id with --id-field _id
+    if [ "${ID_FIELDS[$i]}" = "_id" ]; then
+        model_id_type="_id: string;"
+        model_id_field="_id: { type: String, required: true },"
+        record_type="{ _id: string; $entity_fields; version: number }"
+        row_type="${Feature}Record"
+        doc_id="_id"
+        cursor_check="typeof decoded.id === 'string'"
+        id_declarations="
+
+// The entity id doubles as _id, so there is no second unique index to maintain
+const toDocument = ({ id, ...fields }: $Feature) => ({ _id: id, ...fields });"
+        to_document="toDocument(${feature})"
+        batch_documents="batch.map(toDocument)"
+        find_by_id_query="${find_by_id_query/findOne(\{ id \}/findById(id}"
+    else
+        model_id_type="id: string;"
+        model_id_field="id: { type: String, required: true, unique: true },"
+        record_type="{ id: string; $entity_fields; version: number }"
+        row_type="${Feature}Record & { _id: Types.ObjectId }"
+        doc_id="id"
+        cursor_check="Types.ObjectId.isValid(decoded.id)"
+        id_declarations=""
+        to_document="${feature}"
+        batch_documents="batch"
+    fi
+
+    # Write path: with --outbox, creates also record a "<feature>.created" event in Core/outbox, in the same transaction
+    if [ "${OUTBOXES[$i]}" = "true" ]; then
+        outbox_import=$'\n'"import { OutboxModel, outboxEvent } from '../../../../Core/outbox/outbox';"
+        outbox_declarations="
+
+// Writes the entity and its '$feature.created' event in one transaction, so the event exists exactly when the entity does
+const insertWithEvent = ($feature: $Feature) =>
+  ${Feature}Model.db.transaction(async (session) => {
+    await new ${Feature}Model($to_document).save({ session });
+    await OutboxModel.create([outboxEvent('$feature.created', $feature.id, $feature)], { session });
+  });"
+        create_write="      await insertWithEvent($feature);"
+        create_many_write="      // Each batch commits its rows and their events in one transaction; input was validated by the bulk middleware,
+      // so hydration and Mongoose validation are skipped. The insert is unordered, so one attempt reports every bad
+      // row; as a write error aborts the transaction, the other rows are then retried once, in a single transaction
+      const insertBatch = (batch: $Feature[]) =>
+        ${Feature}Model.db.transaction(async (session) => {
+          await ${Feature}Model.insertMany($batch_documents, { session, ordered: false, lean: true });
+          await OutboxModel.insertMany(batch.map((item) => outboxEvent('$feature.created', item.id, item)), { session });
+        });
+      let pending = batch.map((item, index) => ({ item, index }));
+      for (let attempt = 0; attempt < 2 && pending.length > 0; attempt++) {
+        try {
+          await insertBatch(pending.map(({ item }) => item));
+          pending = [];
+        } catch (error) {
+          const writeErrors = (error as { writeErrors?: WriteError | WriteError[] }).writeErrors;
+          const failed = new Set<number>();
+          for (const writeError of writeErrors ? ([] as WriteError[]).concat(writeErrors) : []) {
+            const statusCode = writeError.code === 11000 ? 409 : 500;
+            failures.set(pending[writeError.index].index, new CustomError(statusCode, 'Failed to create $feature: ' + writeError.errmsg));
+            failed.add(writeError.index);
+          }
+          pending = pending.filter((_, position) => !failed.has(position));
+          // Without row errors (e.g. lost connection), or on the retry, the rows left were rolled back and are not stored
+          if (failed.size === 0 || attempt === 1) {
+            const failure = new CustomError(500, 'Failed to create $feature: ' + (error as Error).message);
+            pending.forEach(({ index }) => failures.set(index, failure));
+            pending = [];
+          }
+        }
+      }"
+    else
+        outbox_import=""
+        outbox_declarations=""
+        create_write="      const ${feature}Doc = new ${Feature}Model($to_document);
+      await ${feature}Doc.save();"
+        create_many_write="      try {
+        // Input was validated by the bulk middleware, so skip hydration and Mongoose validation;
+        // unordered inserts let one bad row fail without blocking the rest of the batch
+        await ${Feature}Model.insertMany($batch_documents, { ordered: false, lean: true });
+      } catch (error) {
+        const writeErrors = (error as { writeErrors?: WriteError | WriteError[] }).writeErrors;
+        if (writeErrors) {
+          for (const writeError of ([] as WriteError[]).concat(writeErrors)) {
+            const statusCode = writeError.code === 11000 ? 409 : 500;
+            failures.set(writeError.index, new CustomError(statusCode, 'Failed to create $feature: ' + writeError.errmsg));
+          }
+        } else {
+          // The batch failed as a whole (e.g. lost connection), so none of its items are known to be stored
+          const failure = new CustomError(500, 'Failed to create $feature: ' + (error as Error).message);
+          batch.forEach((_, index) => failures.set(index, failure));
+        }
+      }"
+    fi
+
+    mkdir -p "Features/$feature/domain/entity" "Features/$feature/domain/usecases" "Features/$feature/domain/repositories"
+    mkdir -p "Features/$feature/data/repositories" "Features/$feature/data/datasources" "Features/$feature/data/models"
+    mkdir -p "Features/$feature/delivery/routes" "Features/$feature/delivery/controllers" "Features/$feature/delivery/middlewares"
+    mkdir -p "__tests__/Features/$feature" bench/load
+    echo "Created folder structure for feature: $feature"
+
+    # Create Features/<feature>/container.ts
+    if [ "$DI_SCOPE" = "request" ]; then
+        tsyringe_imports="container, Lifecycle"
+    else
+        tsyringe_imports="container"
+    fi
+    # With --cache, the cached datasource takes the DataSource token and wraps the Mongo one
+    case "${CACHES[$i]}" in
+        memory)
+            cache_factory="new ReadThroughCache(new MemoryCache<$Feature>(Number(process.env.CACHE_MAX_ENTRIES) || 10000, Number(process.env.CACHE_TTL_MS) || 30000))"
+            cache_staleness="Each process has its own copy: a write clears only the writer's, so other cluster workers or instances serve the old $feature for up to CACHE_TTL_MS."
+            ;;
+        redis)
+            cache_factory="new ReadThroughCache(new TieredCache<$Feature>(
+    new MemoryCache(Number(process.env.CACHE_MAX_ENTRIES) || 10000, Number(process.env.CACHE_MEMORY_TTL_MS) || 5000),
+    new RedisCache('$feature', Number(process.env.CACHE_TTL_MS) || 30000, (raw: $Feature) => new $Feature(raw.id, $raw_args, raw.version)),
+    new RedisInvalidator('$feature'),
+  ))"
+            cache_staleness="Writes are published over Redis pub/sub so every process drops its in-memory copy; one that misses the message serves the old $feature for up to CACHE_MEMORY_TTL_MS."
+            ;;
+    esac
+    if [ "${CACHES[$i]}" = "none" ]; then
+        cache_imports=""
+        di_register "'${Feature}DataSource'" "${Feature}DataSource"
+        datasource_registrations="$REPLY"
+    else
+        tsyringe_imports+=", instanceCachingFactory"
+        if [ "${CACHES[$i]}" = "redis" ]; then
+            cache_classes="MemoryCache, TieredCache, ReadThroughCache"
+            redis_import=$'\n'"import { RedisCache, RedisInvalidator } from '../../Core/cache/redis-cache';"
+        else
+            cache_classes="MemoryCache, ReadThroughCache"
+            redis_import=""
+        fi
+        cache_imports="
+import { Cached${Feature}DataSource } from './data/datasources/$feature.cached.datasource';
+import { $Feature } from './domain/entity/$feature.entity';
+import { $cache_classes } from '../../Core/cache/cache';$redis_import"
+        di_register "'${Feature}MongoDataSource'" "${Feature}DataSource"
+        datasource_registrations="$REPLY"
+        di_register "'${Feature}DataSource'" "Cached${Feature}DataSource"
+        datasource_registrations+="
+$REPLY
+// Built on first resolve (after dotenv has run) and shared process-wide whatever the DI scope, so hits and in-flight loads are shared.
+// $cache_staleness
+container.register('${Feature}Cache', { useFactory: instanceCachingFactory(() => $cache_factory) });"
+    fi
+    render_template "Features/$feature/container.ts" container.ts
+    echo "Created Features/$feature/container.ts"
+
+    # Create Features/<feature>/domain/entity/<feature>.entity.ts
+    render_template "Features/$feature/domain/entity/$feature.entity.ts" entity.ts
+    echo "Created Features/$feature/domain/entity/$feature.entity.ts"
+
+    # Create Features/<feature>/domain/repositories/<feature>.repository.interface.ts
+    render_template "Features/$feature/domain/repositories/$feature.repository.interface.ts" repository.interface.ts
+    echo "Created Features/$feature/domain/repositories/$feature.repository.interface.ts"
+
+    # With --offload worker, the create use cases run their input through Features/<feature>/domain/workers first
+    if [ "${OFFLOADS[$i]}" = "worker" ]; then
+        mkdir -p "Features/$feature/domain/workers"
+        render_template "Features/$feature/domain/workers/$feature.task.ts" worker.task.ts
+        echo "Created Features/$feature/domain/workers/$feature.task.ts"
+        render_template "__tests__/Features/$feature/$feature.task.test.ts" worker.task.test.ts
+        echo "Created __tests__/Features/$feature/$feature.task.test.ts"
+        create_offload_import="
+import { workerPool } from '../../../../Core/workers/pool';
+import { prepare${Feature}Task } from '../workers/$feature.task';"
+        create_many_offload_import="
+import { workerPool } from '../../../../Core/workers/pool';
+import { prepare${Feature}ListTask } from '../workers/$feature.task';"
+        create_many_err_import=", Err"
+        create_offload="
+    const prepared = await workerPool().run<Create${Feature}Dto>(prepare${Feature}Task, dto);
+    if (prepared.isErr()) return Err(prepared.unwrapErr());
+    dto = prepared.unwrap();"
+        create_many_offload="
+    const prepared = await workerPool().run<Create${Feature}Dto[]>(prepare${Feature}ListTask, dtos);
+    if (prepared.isErr()) return Err(prepared.unwrapErr());
+    dtos = prepared.unwrap();"
+    else
+        create_offload_import=""
+        create_many_offload_import=""
+        create_many_err_import=""
+        create_offload=""
+        create_many_offload=""
+    fi
+
+    # Create Features/<feature>/domain/usecases/create-<feature>.usecase.ts
+    render_template "Features/$feature/domain/usecases/create-$feature.usecase.ts" create.usecase.ts
+    echo "Created Features/$feature/domain/usecases/create-$feature.usecase.ts"
+
+    # Create Features/<feature>/domain/usecases/create-many-<feature>.usecase.ts
+    render_template "Features/$feature/domain/usecases/create-many-$feature.usecase.ts" create-many.usecase.ts
+    echo "Created Features/$feature/domain/usecases/create-many-$feature.usecase.ts"
+
+    # Create Features/<feature>/domain/usecases/list-<feature>.usecase.ts
+    render_template "Features/$feature/domain/usecases/list-$feature.usecase.ts" list.usecase.ts
+    echo "Created Features/$feature/domain/usecases/list-$feature.usecase.ts"
+
+    # Create Features/<feature>/domain/usecases/update-<feature>.usecase.ts and delete-<feature>.usecase.ts
+    render_template "Features/$feature/domain/usecases/update-$feature.usecase.ts" update.usecase.ts
+    echo "Created Features/$feature/domain/usecases/update-$feature.usecase.ts"
+    render_template "Features/$feature/domain/usecases/delete-$feature.usecase.ts" delete.usecase.ts
+    echo "Created Features/$feature/domain/usecases/delete-$feature.usecase.ts"
+
+    # Create Features/<feature>/data/models/<feature>.model.ts
+    render_template "Features/$feature/data/models/$feature.model.ts" model.ts
+    echo "Created Features/$feature/data/models/$feature.model.ts"
+
+    # Create Features/<feature>/data/datasources/<feature>.datasource.ts
+    render_template "Features/$feature/data/datasources/$feature.datasource.ts" datasource.ts
+    echo "Created Features/$feature/data/datasources/$feature.datasource.ts"
+
+    if [ "${CACHES[$i]}" != "none" ]; then
+        # Create Features/<feature>/data/datasources/<feature>.cached.datasource.ts
+        render_template "Features/$feature/data/datasources/$feature.cached.datasource.ts" cached.datasource.ts
+        echo "Created Features/$feature/data/datasources/$feature.cached.datasource.ts"
+
+        # Create __tests__/Features/<feature>/<feature>.cache.test.ts
+        render_template "__tests__/Features/$feature/$feature.cache.test.ts" cache.test.ts
+        echo "Created __tests__/Features/$feature/$feature.cache.test.ts"
+    fi
+
+    # Create Features/<feature>/data/repositories/<feature>.repository.ts
+    render_template "Features/$feature/data/repositories/$feature.repository.ts" repository.ts
+    echo "Created Features/$feature/data/repositories/$feature.repository.ts"
+
+    # Create Features/<feature>/delivery/middlewares/<feature>.validator.ts
+    if [ "${VALIDATORS[$i]}" = "inline" ]; then
+        validate_record="  return check${Feature}(body);"
+    else
+        validate_record="  const result = ${feature}Schema.safeParse(body);
+  return result.success ? null : format${Feature}Issues(result.error.issues);"
+    fi
+    render_template "Features/$feature/delivery/middlewares/$feature.validator.ts" validator.ts
+    echo "Created Features/$feature/delivery/middlewares/$feature.validator.ts"
+
+    if [ "$HTTP_FRAMEWORK" = "express" ]; then
+        # Create Features/<feature>/delivery/middlewares/validate-<feature>.middleware.ts
+        if [ "${VALIDATORS[$i]}" = "inline" ]; then
+            validator_import="check${Feature}, check${Feature}Patch"
+            validate_single="const message = check${Feature}(req.body);
+  if (message === null) return next();
+  next(Err(new CustomError(400, message)));"
+            validate_patch="const message = check${Feature}Patch(req.body);
+  if (message === null) return next();
+  next(Err(new CustomError(400, message)));"
+            validate_bulk="if (!Array.isArray(req.body) || req.body.length === 0) {
+    return next(Err(new CustomError(400, 'body must be a non-empty array')));
+  }
+  for (let index = 0; index < req.body.length; index++) {
+    const message = check${Feature}(req.body[index]);
+    if (message !== null) return next(Err(new CustomError(400, index + '.' + message)));
+  }
+  next();"
+        else
+            validator_import="${feature}Schema, ${feature}BulkSchema, ${feature}PatchSchema, format${Feature}Issues"
+            validate_single="const result = ${feature}Schema.safeParse(req.body);
+  if (result.success) return next();
+  next(Err(new CustomError(400, format${Feature}Issues(result.error.issues))));"
+            validate_patch="const result = ${feature}PatchSchema.safeParse(req.body);
+  if (result.success) return next();
+  next(Err(new CustomError(400, format${Feature}Issues(result.error.issues))));"
+            validate_bulk="// The whole array is checked in a single Zod pass; issue paths carry the index of the offending item
+  const result = ${feature}BulkSchema.safeParse(req.body);
+  if (result.success) return next();
+  next(Err(new CustomError(400, format${Feature}Issues(result.error.issues))));"
+        fi
+        render_template "Features/$feature/delivery/middlewares/validate-$feature.middleware.ts" validate.middleware.ts
+        echo "Created Features/$feature/delivery/middlewares/validate-$feature.middleware.ts"
+    fi
+
+    # Create bench/<feature>.validation.bench.ts
+    render_template "bench/$feature.validation.bench.ts" validation.bench.ts
+    echo "Created bench/$feature.validation.bench.ts"
+
+    # Create bench/load/<feature>.load.ts
+    unique_overrides=""
+    for j in "${!field_names[@]}"; do
+        [[ ":${field_rules[$j]}:" == *":unique:"* ]] || continue
+        name="${field_names[$j]}"
+        case "${field_types[$j]}" in
+            string)
+                if [[ ":${field_rules[$j]}:" == *":email:"* ]]; then
+                    unique_overrides+=", $name: 'load' + n + '@example.com'"
+                else
+                    unique_overrides+=", $name: 'sample_${name}_' + n"
+                fi
+                ;;
+            number) unique_overrides+=", $name: n" ;;
+        esac
+    done
+    # Without unique fields every request can send the same body, built once
+    if [ -n "$unique_overrides" ]; then
+        load_record="let sequence = 0;
+// Fields with a unique index get a fresh value per request so inserts are not rejected as duplicates
+const record = (): Record<string, unknown> => {
+  const n = sequence++;
+  return { ...sample$unique_overrides };
+};"
+        load_body="() => "
+    else
+        load_record="const record = (): Record<string, unknown> => sample;"
+        load_body=""
+    fi
+    render_template "bench/load/$feature.load.ts" load.ts
+    echo "Created bench/load/$feature.load.ts"
+
+    # Fastify compiles its serializers from the route schemas; the --target handlers use the generated ones
+    if [ "$HTTP_FRAMEWORK" = "express" ] || [ "$TARGET" != "server" ]; then
+        # Create Features/<feature>/delivery/serializers/<feature>.serializer.ts
+        mkdir -p "Features/$feature/delivery/serializers"
+        render_template "Features/$feature/delivery/serializers/$feature.serializer.ts" serializer.ts
+        echo "Created Features/$feature/delivery/serializers/$feature.serializer.ts"
+
+        # Create __tests__/Features/<feature>/<feature>.serializer.test.ts
+        render_template "__tests__/Features/$feature/$feature.serializer.test.ts" serializer.test.ts
+        echo "Created __tests__/Features/$feature/$feature.serializer.test.ts"
+    fi
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        # Create Features/<feature>/delivery/schemas/<feature>.schema.ts
+        mkdir -p "Features/$feature/delivery/schemas"
+        render_template "Features/$feature/delivery/schemas/$feature.schema.ts" schema.ts
+        echo "Created Features/$feature/delivery/schemas/$feature.schema.ts"
+    fi
+
+    # Create Features/<feature>/delivery/controllers/<feature>.controller.ts
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        render_template "Features/$feature/delivery/controllers/$feature.controller.ts" controller.fastify.ts
+    else
+        render_template "Features/$feature/delivery/controllers/$feature.controller.ts" controller.express.ts
+    fi
+    echo "Created Features/$feature/delivery/controllers/$feature.controller.ts"
+
+    # Create __tests__/Features/<feature>/<feature>.usecase.test.ts
+    case "$DI_SCOPE" in
+        singleton) scope_assertions="    expect(container.resolve('Create${Feature}UseCase')).toBe(create${Feature}UseCase);" ;;
+        transient) scope_assertions="    expect(container.resolve('Create${Feature}UseCase')).not.toBe(create${Feature}UseCase);" ;;
+        request)
+            scope_assertions="    const requestContainer = container.createChildContainer();
+    const first = requestContainer.resolve('Create${Feature}UseCase');
+    expect(requestContainer.resolve('Create${Feature}UseCase')).toBe(first);
+    expect(container.createChildContainer().resolve('Create${Feature}UseCase')).not.toBe(first);"
+            ;;
+    esac
+    render_template "__tests__/Features/$feature/$feature.usecase.test.ts" usecase.test.ts
+    echo "Created __tests__/Features/$feature/$feature.usecase.test.ts"
+
+    # Create __tests__/Features/<feature>/<feature>.controller.test.ts
+    if [ "$HTTP_FRAMEWORK" = "fastify" ]; then
+        render_template "__tests__/Features/$feature/$feature.controller.test.ts" controller.fastify.test.ts
+    else
+        render_template "__tests__/Features/$feature/$feature.controller.test.ts" controller.express.test.ts
+    fi
+    echo "Created __tests__/Features/$feature/$feature.controller.test.ts"
+
+    if [ "$TARGET" != "server" ]; then
+        # Create Features/<feature>/delivery/handlers/<feature>.handler.ts
+        if [ "${VALIDATORS[$i]}" = "inline" ]; then
+            handler_validator_import="validate${Feature}Record, check${Feature}Patch"
+            handler_validate_patch="const message = check${Feature}Patch(body.unwrap());"
+        else
+            handler_validator_import="validate${Feature}Record, ${feature}PatchSchema, format${Feature}Issues"
+            handler_validate_patch="const patch = ${feature}PatchSchema.safeParse(body.unwrap());
+    const message = patch.success ? null : format${Feature}Issues(patch.error.issues);"
+        fi
+        server_entry="$SERVER_ENTRY"
+        mkdir -p "Features/$feature/delivery/handlers"
+        render_template "Features/$feature/delivery/handlers/$feature.handler.ts" handler.ts
+        echo "Created Features/$feature/delivery/handlers/$feature.handler.ts"
+
+        # Create __tests__/Features/<feature>/<feature>.handler.test.ts
+        render_template "__tests__/Features/$feature/$feature.handler.test.ts" handler.test.ts
+        echo "Created __tests__/Features/$feature/$feature.handler.test.ts"
+    fi
+}
+# With more than one job (the default for 'tsclean apply'), features are generated in background batches of
+# GENERATE_JOBS. Each job's output is replayed in order afterwards, and its sample payload comes back through
+# the job directory for README.md
+if [ "$GENERATE_JOBS" -gt 1 ] && [ "${#FEATURES[@]}" -gt 1 ]; then
+    jobs_dir=$(mktemp -d)
+    failed_features=""
+    batch=()
+    for i in "${!FEATURES[@]}"; do
+        (
+            generate_feature && printf '%s' "${sample_jsons[$i]}" > "$jobs_dir/$i.sample"
+        ) > "$jobs_dir/$i.log" 2>&1 &
+        batch+=("$i:$!")
+        if [ "${#batch[@]}" -ge "$GENERATE_JOBS" ] || [ "$i" -eq $((${#FEATURES[@]} - 1)) ]; then
+            for job in "${batch[@]}"; do
+                wait "${job#*:}" || failed_features+=" ${FEATURES[${job%%:*}]}"
+            done
+            batch=()
+        fi
+    done
+    for i in "${!FEATURES[@]}"; do
+        cat "$jobs_dir/$i.log"
+        [ -f "$jobs_dir/$i.sample" ] && IFS= read -r "sample_jsons[$i]" < "$jobs_dir/$i.sample"
+    done
+    rm -rf "$jobs_dir"
+    if [ -n "$failed_features" ]; then
+        echo "Error: generating failed for:$failed_features"
+        exit 1
+    fi
+    phase_done "features ($GENERATE_JOBS jobs)"
+else
+    for i in "${!FEATURES[@]}"; do
+        generate_feature
+        phase_done "feature ${FEATURES[$i]}"
+    done
+fi
+
+# Create Core/workers/*.ts when a feature offloads work to worker threads
+if [[ " ${OFFLOADS[*]} " == *" worker "* ]]; then
+    mkdir -p Core/workers
+    cat > Core/workers/pool.ts << EOL
+import { Worker, TransferListItem } from 'node:worker_threads';
+import os from 'node:os';
+import path from 'node:path';
+import { Result, Ok, Err } from '../result/result';
+import { CustomError } from '../error/custom-error';
+
+// A task is a function exported by a module, referenced by file and export name so a worker can load it:
+// export const hashTask = { file: __filename, name: 'hash' };
+export interface WorkerTask {
+  file: string;
+  name: string;
+}
+
+type Job = {
+  task: WorkerTask;
+  payload: unknown;
+  transferList: readonly TransferListItem[];
+  resolve: (result: Result<unknown, CustomError>) => void;
+};
+
+export const TRANSFER = Symbol.for('tsclean.transfer');
+export type Transfer = { [TRANSFER]: true; value: unknown; transferList: readonly TransferListItem[] };
+
+// Returned by a task, moves the listed ArrayBuffers back to the caller instead of copying them
+export const transfer = <T>(value: T, transferList: readonly TransferListItem[]): T =>
+  ({ [TRANSFER]: true, value, transferList }) as Transfer as unknown as T;
+
+const WORKER_FILE = path.join(__dirname, 'worker' + path.extname(__filename));
+
+// A fixed-size pool of worker threads for CPU-heavy task functions, so they run beside the event loop that serves
+// every request instead of on it. Threads start on demand and are unref'd, so an idle pool never holds the process
+// open; a thread that dies fails its job and is replaced by the next dispatch. Past maxQueue waiting jobs, run()
+// answers 503 rather than queueing without bound.
+export class WorkerPool {
+  private workers = new Set<Worker>();
+  private idle: Worker[] = [];
+  private busy = new Map<Worker, Job>();
+  private queue: Job[] = [];
+
+  constructor(
+    private readonly size: number,
+    private readonly maxQueue: number,
+  ) {}
+
+  // Runs the task on the next free thread. The payload is structured-cloned, except for transferList entries,
+  // which move to the worker; a task that throws resolves to Err(500) like any other failure.
+  run<T>(task: WorkerTask, payload: unknown, transferList: readonly TransferListItem[] = []): Promise<Result<T, CustomError>> {
+    if (this.queue.length >= this.maxQueue) {
+      return Promise.resolve(Err(new CustomError(503, 'Worker pool queue is full')));
+    }
+    return new Promise((resolve) => {
+      this.queue.push({ task, payload, transferList, resolve: resolve as Job['resolve'] });
+      this.dispatch();
+    });
+  }
+
+  private dispatch(): void {
+    while (this.queue.length > 0) {
+      const worker = this.idle.pop() ?? (this.workers.size < this.size ? this.spawn() : undefined);
+      if (!worker) return;
+      const job = this.queue.shift() as Job;
+      this.busy.set(worker, job);
+      worker.postMessage({ file: job.task.file, name: job.task.name, payload: job.payload }, job.transferList);
+    }
+  }
+
+  private spawn(): Worker {
+    // Under ts-node (npm run dev) and ts-jest the thread compiles the TypeScript it loads itself
+    const worker = WORKER_FILE.endsWith('.ts')
+      ? new Worker("require('ts-node/register/transpile-only'); require(" + JSON.stringify(WORKER_FILE) + ');', { eval: true })
+      : new Worker(WORKER_FILE);
+    worker.unref();
+    this.workers.add(worker);
+    worker.on('message', (message: { value?: unknown; error?: string }) => {
+      const job = this.busy.get(worker);
+      this.busy.delete(worker);
+      this.idle.push(worker);
+      if (job) {
+        job.resolve(message.error === undefined ? Ok(message.value) : Err(new CustomError(500, job.task.name + ' failed: ' + message.error)));
+      }
+      this.dispatch();
+    });
+    worker.on('error', (error) => this.retire(worker, error.message));
+    worker.on('exit', (code) => this.retire(worker, 'worker exited with code ' + code));
+    return worker;
+  }
+
+  private retire(worker: Worker, reason: string): void {
+    if (!this.workers.delete(worker)) return;
+    const job = this.busy.get(worker);
+    this.busy.delete(worker);
+    this.idle = this.idle.filter((item) => item !== worker);
+    job?.resolve(Err(new CustomError(500, job.task.name + ' failed: ' + reason)));
+    this.dispatch();
+  }
+}
+
+// One pool per process, sized on first use (after dotenv): WORKER_POOL_SIZE threads, by default one per core but the
+// one the event loop runs on, and at most WORKER_POOL_MAX_QUEUE waiting jobs. In cluster mode every worker process has
+// its own pool, so lower WORKER_POOL_SIZE to keep the total near the core count.
+let sharedPool: WorkerPool | null = null;
+export const workerPool = (): WorkerPool =>
+  (sharedPool ??= new WorkerPool(
+    Number(process.env.WORKER_POOL_SIZE) || Math.max(1, os.availableParallelism() - 1),
+    Number(process.env.WORKER_POOL_MAX_QUEUE) || 1000,
+  ));
+EOL
+    echo "Created Core/workers/pool.ts"
+
+    cat > Core/workers/worker.ts << EOL
+import { parentPort } from 'node:worker_threads';
+import { TRANSFER, Transfer } from './pool';
+
+type TaskFunction = (payload: unknown) => unknown;
+
+// Task modules are loaded on a thread's first job for them and kept for the ones after
+const tasks = new Map<string, TaskFunction>();
+const loadTask = (file: string, name: string): TaskFunction => {
+  const key = file + '#' + name;
+  let task = tasks.get(key);
+  if (!task) {
+    // eslint-disable-next-line @typescript-eslint/no-var-requires
+    task = require(file)[name] as TaskFunction;
+    if (typeof task !== 'function') throw new Error(name + ' is not a function exported by ' + file);
+    tasks.set(key, task);
+  }
+  return task;
+};
+
+// One job at a time: the pool sends the next one only after this thread has answered
+parentPort?.on('message', async ({ file, name, payload }: { file: string; name: string; payload: unknown }) => {
+  try {
+    const result = await loadTask(file, name)(payload);
+    const moved = (result as Partial<Transfer> | undefined)?.[TRANSFER] ? (result as Transfer) : undefined;
+    parentPort?.postMessage({ value: moved ? moved.value : result }, moved ? moved.transferList : []);
+  } catch (error) {
+    parentPort?.postMessage({ error: (error as Error).message ?? String(error) });
+  }
+});
+EOL
+    echo "Created Core/workers/worker.ts"
+fi
+
+# Create Core/outbox/*.ts when a feature records its creates as outbox events
+if [[ " ${OUTBOXES[*]} " == *" true "* ]]; then
+    mkdir -p Core/outbox __tests__/Core
+    cat > Core/outbox/outbox.ts << EOL
+import mongoose, { Schema } from 'mongoose';
+
+// An event written by a datasource in the same transaction as the change it describes, and relayed afterwards
+export interface OutboxEvent {
+  topic: string;
+  key: string;
+  payload: unknown;
+  createdAt: Date;
+}
+
+type OutboxRecord = OutboxEvent & { publishedAt: Date | null };
+
+const OutboxSchema = new Schema<OutboxRecord>(
+  {
+    topic: { type: String, required: true },
+    key: { type: String, required: true },
+    payload: { type: Schema.Types.Mixed, required: true },
+    createdAt: { type: Date, required: true },
+    publishedAt: { type: Date, default: null },
+  },
+  { versionKey: false }
+);
+// The relay reads the oldest unpublished events; MongoDB removes published ones after seven days
+OutboxSchema.index({ publishedAt: 1, _id: 1 });
+OutboxSchema.index({ publishedAt: 1 }, { expireAfterSeconds: 7 * 24 * 60 * 60 });
+
+export const OutboxModel = mongoose.model<OutboxRecord>('Outbox', OutboxSchema, 'outbox');
+
+export const outboxEvent = (topic: string, key: string, payload: unknown): OutboxEvent => ({
+  topic,
+  key,
+  payload,
+  createdAt: new Date(),
+});
+EOL
+    echo "Created Core/outbox/outbox.ts"
+
+    cat > Core/outbox/relay.ts << EOL
+import Redis from 'ioredis';
+import { OutboxModel, OutboxEvent } from './outbox';
+
+export type RelayedEvent = OutboxEvent & { id: string };
+
+// Where relayed events go. publish() resolves once every event is accepted; if it rejects, the whole batch stays in
+// the outbox and is sent again. Implement it over a Kafka or NATS producer to publish there instead of Redis.
+export interface OutboxPublisher {
+  publish(events: RelayedEvent[]): Promise<void>;
+}
+
+// The outbox as the relay sees it: the oldest unpublished events, and a way to mark them published
+export interface OutboxStore {
+  pending(limit: number): Promise<RelayedEvent[]>;
+  markPublished(ids: string[]): Promise<void>;
+}
+
+export const mongoOutboxStore: OutboxStore = {
+  async pending(limit) {
+    const rows = await OutboxModel.find({ publishedAt: null }).sort({ _id: 1 }).limit(limit).lean();
+    return rows.map(({ _id, topic, key, payload, createdAt }) => ({ id: String(_id), topic, key, payload, createdAt }));
+  },
+  async markPublished(ids) {
+    await OutboxModel.updateMany({ _id: { \$in: ids } }, { \$set: { publishedAt: new Date() } });
+  },
+};
+
+// Appends each event to the Redis stream OUTBOX_STREAM_PREFIX + topic, trimmed to about OUTBOX_STREAM_MAXLEN entries,
+// in one round trip per batch
+export class RedisStreamPublisher implements OutboxPublisher {
+  private client = new Redis(process.env.REDIS_URL || 'redis://localhost:6379', { maxRetriesPerRequest: 1 });
+  private prefix = process.env.OUTBOX_STREAM_PREFIX ?? 'events:';
+  private maxLength = Number(process.env.OUTBOX_STREAM_MAXLEN) || 100000;
+
+  constructor() {
+    this.client.on('error', (error) => console.error('Redis error:', error.message));
+  }
+
+  async publish(events: RelayedEvent[]): Promise<void> {
+    const pipeline = this.client.pipeline();
+    for (const event of events) {
+      const fields = ['id', event.id, 'key', event.key, 'payload', JSON.stringify(event.payload), 'createdAt', event.createdAt.toISOString()];
+      pipeline.xadd(this.prefix + event.topic, 'MAXLEN', '~', this.maxLength, '*', ...fields);
+    }
+    const failed = (await pipeline.exec())?.find(([error]) => error);
+    if (failed) throw failed[0];
+  }
+}
+
+// Moves events from the store to the publisher in batches of OUTBOX_BATCH_SIZE, oldest first, until none are left,
+// then sleeps OUTBOX_POLL_MS or until notify(). Delivery is at least once: a crash between publishing a batch and
+// marking it sends the batch again, so consumers deduplicate on the event id.
+export class OutboxRelay {
+  private wake: (() => void) | null = null;
+  private stopped = false;
+
+  constructor(
+    private readonly publisher: OutboxPublisher,
+    private readonly store: OutboxStore,
+    private readonly batchSize = Number(process.env.OUTBOX_BATCH_SIZE) || 100,
+    private readonly pollMs = Number(process.env.OUTBOX_POLL_MS) || 1000,
+  ) {}
+
+  // Relays until the store has no unpublished events; resolves to how many were published
+  async drain(): Promise<number> {
+    let published = 0;
+    for (;;) {
+      const events = await this.store.pending(this.batchSize);
+      if (events.length === 0) return published;
+      await this.publisher.publish(events);
+      await this.store.markPublished(events.map((event) => event.id));
+      published += events.length;
+      if (events.length < this.batchSize) return published;
+    }
+  }
+
+  // Resolves once stop() was called and the batch in flight, if any, is published and marked
+  async run(): Promise<void> {
+    while (!this.stopped) {
+      try {
+        await this.drain();
+      } catch (error) {
+        console.error('Outbox relay failed, retrying:', (error as Error).message);
+      }
+      if (this.stopped) return;
+      await new Promise<void>((resolve) => {
+        const timer = setTimeout(resolve, this.pollMs);
+        timer.unref();
+        this.wake = () => {
+          clearTimeout(timer);
+          resolve();
+        };
+      });
+      this.wake = null;
+    }
+  }
+
+  // Cuts the current sleep short, e.g. when a new event is written
+  notify(): void {
+    this.wake?.();
+  }
+
+  stop(): void {
+    this.stopped = true;
+    this.notify();
+  }
+}
+
+// Started by Server/index.ts in one process per deployment: set OUTBOX_RELAY=off on the others. Inserts into the
+// outbox wake the relay through a change stream, so events go out as soon as their transaction commits. Returns the
+// stop hook for drainOnShutdown, which closes the change stream and waits for the batch in flight.
+export const startOutboxRelay = (publisher: OutboxPublisher = new RedisStreamPublisher()): (() => Promise<void>) => {
+  const relay = new OutboxRelay(publisher, mongoOutboxStore);
+  const changes = OutboxModel.watch([{ \$match: { operationType: 'insert' } }])
+    .on('change', () => relay.notify())
+    .on('error', (error) => console.warn('Outbox change stream closed, polling every OUTBOX_POLL_MS:', error.message));
+  const running = relay.run();
+  return async () => {
+    relay.stop();
+    await Promise.all([changes.close(), running]);
   };
-}
+};
+EOL
+    echo "Created Core/outbox/relay.ts"
 
-export function Err<E>(error: E): Err<E> {
+    # Create __tests__/Core/outbox.test.ts
+    cat > __tests__/Core/outbox.test.ts << EOL
+import { OutboxRelay, OutboxPublisher, OutboxStore, RelayedEvent } from '../../Core/outbox/relay';
+import { outboxEvent } from '../../Core/outbox/outbox';
+
+const memoryStore = (events: RelayedEvent[]): OutboxStore & { published: Set<string> } => {
+  const published = new Set<string>();
   return {
-    kind: 'Err',
-    error,
-    isOk: () => false,
-    isErr: () => true,
-    unwrap: () => { throw new Error('Cannot unwrap an Err value'); },
-    unwrapErr: () => error,
+    published,
+    async pending(limit) {
+      return events.filter((event) => !published.has(event.id)).slice(0, limit);
+    },
+    async markPublished(ids) {
+      ids.forEach((id) => published.add(id));
+    },
   };
-}
-EOL
-    echo "Created Core/result/result.ts"
+};
 
-    # Create Core/error/custom-error.ts
-    cat > Core/error/custom-error.ts << EOL
-export class CustomError extends Error {
-  constructor(public statusCode: number, message: string) {
-    super(message);
-    this.name = 'CustomError';
-  }
-}
-EOL
-    echo "Created Core/error/custom-error.ts"
+const events = (count: number): RelayedEvent[] =>
+  Array.from({ length: count }, (_, index) => ({ id: String(index), ...outboxEvent('orders.created', 'k' + index, { index }) }));
 
-    # Create Core/config/database.ts
-    cat > Core/config/database.ts << EOL
-import mongoose from 'mongoose';
+describe('OutboxRelay', () => {
+  it('should publish every pending event in batches, oldest first', async () => {
+    const store = memoryStore(events(5));
+    const publisher: OutboxPublisher = { publish: jest.fn().mockResolvedValue(undefined) };
 
-export const connectToDatabase = async () => {
-  const uri = process.env.MONGODB_URI;
-  if (!uri) {
-    throw new Error('MONGODB_URI is not defined in .env');
-  }
-  await mongoose.connect(uri);
-  console.log('Connected to MongoDB');
-};
+    const published = await new OutboxRelay(publisher, store, 2, 10).drain();
+
+    expect(published).toBe(5);
+    expect(publisher.publish).toHaveBeenCalledTimes(3);
+    expect((publisher.publish as jest.Mock).mock.calls[0][0].map((event: RelayedEvent) => event.id)).toEqual(['0', '1']);
+    expect(store.published.size).toBe(5);
+  });
+
+  it('should leave a batch in the outbox when publishing fails', async () => {
+    const store = memoryStore(events(3));
+    const publisher: OutboxPublisher = { publish: jest.fn().mockRejectedValue(new Error('broker down')) };
+
+    await expect(new OutboxRelay(publisher, store, 10, 10).drain()).rejects.toThrow('broker down');
+    expect(store.published.size).toBe(0);
+  });
+});
 EOL
-    echo "Created Core/config/database.ts"
+    echo "Created __tests__/Core/outbox.test.ts"
+    if [ "$COMMAND" = "feature" ] && ! grep -q '"ioredis"' package.json; then
+        add_packages --save ioredis@^5.4.1
+    fi
 fi
 
-# Generate or update Server/index.ts
-server_content="import 'reflect-metadata';
-import express from 'express';
-import dotenv from 'dotenv';
-import { container } from 'tsyringe';
-import { connectToDatabase } from '../Core/config/database';
-$(for feature in "${FEATURES[@]}"; do
-    Feature=$(capitalize "$feature")
-    echo "import { ${Feature}Controller } from '../Features/$feature/delivery/controllers/$feature.controller';"
-done)
+# Create Core/config/replica-reads.ts when a feature reads from replica set secondaries (--replica-reads)
+if [[ " ${REPLICA_READS[*]} " == *" true "* ]]; then
+    mkdir -p Core/config __tests__/Core
+    cat > Core/config/replica-reads.ts << EOL
+import mongoose from 'mongoose';
 
-dotenv.config();
+type ReadMode = 'primary' | 'primaryPreferred' | 'secondary' | 'secondaryPreferred' | 'nearest';
 
-const app = express();
-const port = process.env.PORT || 3000;
+const READ_MODES = new Set<string>(['primary', 'primaryPreferred', 'secondary', 'secondaryPreferred', 'nearest']);
 
-app.use(express.json());
-$(for feature in "${FEATURES[@]}"; do
-    Feature=$(capitalize "$feature")
-    echo "const ${feature}Controller = container.resolve(${Feature}Controller);"
-    echo "app.use('/api/$feature', ${feature}Controller.getRouter());"
-done)
+const preferences = new Map<string, mongoose.mongo.ReadPreference>();
 
-const startServer = async () => {
-  try {
-    await connectToDatabase();
-    app.listen(port, () => {
-      console.log(\`Server running on http://localhost:\${port}\`);
-    });
-  } catch (error) {
-    console.error('Failed to start server:', error);
+// The read preference for a --replica-reads feature's findById and list queries: MONGO_<FEATURE>_READ_PREFERENCE,
+// else MONGO_REPLICA_READ_PREFERENCE (default secondaryPreferred). MONGO_REPLICA_MAX_STALENESS_SECONDS (90 or more)
+// skips secondaries lagging further behind the primary; it cannot apply to primary reads and is dropped for them.
+// Built on first use, after dotenv has run, then reused for every query.
+export const readPreferenceFor = (feature: string): mongoose.mongo.ReadPreference => {
+  let preference = preferences.get(feature);
+  if (!preference) {
+    const configured = process.env['MONGO_' + feature.toUpperCase() + '_READ_PREFERENCE'] || process.env.MONGO_REPLICA_READ_PREFERENCE;
+    const mode = (configured && READ_MODES.has(configured) ? configured : 'secondaryPreferred') as ReadMode;
+    const maxStalenessSeconds = Number(process.env.MONGO_REPLICA_MAX_STALENESS_SECONDS) || undefined;
+    preference = new mongoose.mongo.ReadPreference(mode, undefined, mode === 'primary' ? {} : { maxStalenessSeconds });
+    preferences.set(feature, preference);
   }
+  return preference;
 };
 
-startServer();"
-echo "$server_content" > Server/index.ts
-echo "Created/Updated Server/index.ts"
+// For Query.read(): its typings only name the modes, but it hands any other value to the driver unchanged, which is
+// how the staleness bound reaches the query along with the mode
+export const replicaReads = (feature: string): ReadMode => readPreferenceFor(feature) as unknown as ReadMode;
+EOL
+    echo "Created Core/config/replica-reads.ts"
 
-# Generate feature-specific files
-sample_jsons=()
-for i in "${!FEATURES[@]}"; do
-    feature="${FEATURES[$i]}"
-    fields="${FIELD_DEFS[$i]}"
-    Feature=$(capitalize "$feature")
+    cat > __tests__/Core/replica-reads.test.ts << EOL
+import { readPreferenceFor } from '../../Core/config/replica-reads';
 
-    # Default fields if none provided
-    if [ -z "$fields" ]; then
-        fields="name:string:minlength=3,email:string:email"
-    fi
+describe('readPreferenceFor', () => {
+  const saved = { ...process.env };
 
-    # Parse fields
-    parse_fields "$fields"
-    entity_fields=""
-    dto_fields=""
-    model_fields=""
-    sample_json=""
-    for j in "${!field_names[@]}"; do
-        name="${field_names[$j]}"
-        type="${field_types[$j]}"
-        rule="${field_rules[$j]}"
-        ts_type=$(to_ts_type "$type")
-        mongoose_type=$(to_mongoose_type "$type")
-        entity_fields+="$name: $ts_type, "
-        dto_fields+="$name: $ts_type;\n    "
-        model_fields+="$name: { type: $mongoose_type, required: true },\n    "
-        case "$type" in
-            string)
-                if [ "$rule" = "email" ]; then
-                    sample_json+="\"$name\": \"test@example.com\", "
-                elif [[ "$rule" =~ ^enum=.* ]]; then
-                    enum_value=$(echo "$rule" | cut -d'=' -f2 | cut -d'|' -f1)
-                    sample_json+="\"$name\": \"$enum_value\", "
-                else
-                    sample_json+="\"$name\": \"sample_${name}\", "
-                fi
-                ;;
-            number) sample_json+="\"$name\": 123, " ;;
-            boolean) sample_json+="\"$name\": true, " ;;
-            *) sample_json+="\"$name\": null, " ;;
-        esac
-    done
-    entity_fields="${entity_fields%, }"
-    sample_json="${sample_json%, }"
-    sample_jsons+=("{$sample_json}")
-    zod_schema=$(get_zod_schema field_names[@] field_types[@] field_rules[@])
+  afterEach(() => {
+    process.env = { ...saved };
+  });
 
-    mkdir -p "Features/$feature/domain/entity" "Features/$feature/domain/usecases" "Features/$feature/domain/repositories"
-    mkdir -p "Features/$feature/data/repositories" "Features/$feature/data/datasources" "Features/$feature/data/models"
-    mkdir -p "Features/$feature/delivery/routes" "Features/$feature/delivery/controllers" "Features/$feature/delivery/middlewares"
-    mkdir -p "__tests__/Features/$feature"
-    echo "Created folder structure for feature: $feature"
+  it('should default to secondaryPreferred with the shared staleness bound', () => {
+    delete process.env.MONGO_REPLICA_READ_PREFERENCE;
+    process.env.MONGO_REPLICA_MAX_STALENESS_SECONDS = '120';
 
-    # Create Features/<feature>/container.ts
-    cat > "Features/$feature/container.ts" << EOL
-import 'reflect-metadata';
-import { container } from 'tsyringe';
-import { ${Feature}Controller } from './delivery/controllers/$feature.controller';
-import { Create${Feature}UseCase } from './domain/usecases/create-$feature.usecase';
-import { ${Feature}RepositoryImpl } from './data/repositories/$feature.repository';
-import { ${Feature}DataSource } from './data/datasources/$feature.datasource';
+    const preference = readPreferenceFor('defaults');
+
+    expect(preference.mode).toBe('secondaryPreferred');
+    expect(preference.maxStalenessSeconds).toBe(120);
+    expect(readPreferenceFor('defaults')).toBe(preference);
+  });
 
-container.register<Create${Feature}UseCase>('Create${Feature}UseCase', Create${Feature}UseCase);
-container.register<${Feature}RepositoryImpl>('${Feature}Repository', ${Feature}RepositoryImpl);
-container.register<${Feature}DataSource>('${Feature}DataSource', ${Feature}DataSource);
-container.register<${Feature}Controller>(${Feature}Controller, ${Feature}Controller);
+  it('should let one feature override the mode and drop the staleness bound for primary reads', () => {
+    process.env.MONGO_REPLICA_READ_PREFERENCE = 'nearest';
+    process.env.MONGO_PINNED_READ_PREFERENCE = 'primary';
+    process.env.MONGO_REPLICA_MAX_STALENESS_SECONDS = '90';
 
-export { container };
+    expect(readPreferenceFor('shared').mode).toBe('nearest');
+    expect(readPreferenceFor('pinned').mode).toBe('primary');
+    expect(readPreferenceFor('pinned').maxStalenessSeconds).toBeUndefined();
+  });
+});
 EOL
-    echo "Created Features/$feature/container.ts"
+    echo "Created __tests__/Core/replica-reads.test.ts"
+fi
 
-    # Create Features/<feature>/domain/entity/<feature>.entity.ts
-    cat > "Features/$feature/domain/entity/$feature.entity.ts" << EOL
-export class $Feature {
-  constructor(
-    public id: string,
-    public $entity_fields
-  ) {}
+# Create Core/cache/*.ts when a feature caches its reads
+if [[ " ${CACHES[*]} " == *" memory "* ]] || [[ " ${CACHES[*]} " == *" redis "* ]]; then
+    mkdir -p Core/cache
+    cat > Core/cache/cache.ts << EOL
+import { Result, Ok } from '../result/result';
+
+export interface Cache<V> {
+  get(key: string): Promise<V | undefined>;
+  set(key: string, value: V): Promise<void>;
+  delete(key: string): Promise<void>;
 }
-EOL
-    echo "Created Features/$feature/domain/entity/$feature.entity.ts"
 
-    # Create Features/<feature>/domain/repositories/<feature>.repository.interface.ts
-    cat > "Features/$feature/domain/repositories/$feature.repository.interface.ts" << EOL
-import { Result } from '../../../../Core/result/result';
-import { $Feature } from '../entity/$feature.entity';
-import { CustomError } from '../../../../Core/error/custom-error';
+// In-process LRU with a per-entry TTL; a Map iterates in insertion order, so its first key is the least recently used
+export class MemoryCache<V> implements Cache<V> {
+  private entries = new Map<string, { value: V; expiresAt: number }>();
+
+  constructor(private maxEntries: number, private ttlMs: number) {}
+
+  async get(key: string): Promise<V | undefined> {
+    const entry = this.entries.get(key);
+    if (!entry) return undefined;
+    this.entries.delete(key);
+    if (entry.expiresAt <= Date.now()) return undefined;
+    this.entries.set(key, entry);
+    return entry.value;
+  }
+
+  async set(key: string, value: V): Promise<void> {
+    this.entries.delete(key);
+    this.entries.set(key, { value, expiresAt: Date.now() + this.ttlMs });
+    if (this.entries.size > this.maxEntries) {
+      this.entries.delete(this.entries.keys().next().value as string);
+    }
+  }
 
-export interface ${Feature}Repository {
-  create(${feature}: $Feature): Promise<Result<$Feature, CustomError>>;
-  findById(id: string): Promise<Result<$Feature | null, CustomError>>;
+  async delete(key: string): Promise<void> {
+    this.entries.delete(key);
+  }
 }
-EOL
-    echo "Created Features/$feature/domain/repositories/$feature.repository.interface.ts"
 
-    # Create Features/<feature>/domain/usecases/create-<feature>.usecase.ts
-    cat > "Features/$feature/domain/usecases/create-$feature.usecase.ts" << EOL
-import { injectable, inject } from 'tsyringe';
-import { $Feature } from '../entity/$feature.entity';
-import { ${Feature}Repository } from '../repositories/$feature.repository.interface';
-import { Result, Ok, Err } from '../../../../Core/result/result';
-import { CustomError } from '../../../../Core/error/custom-error';
+// Carries deletes between processes (RedisInvalidator with --cache redis): publish() announces a key this process
+// changed, and subscribe() hears the keys the other processes changed
+export interface Invalidator {
+  publish(key: string): Promise<void>;
+  subscribe(listener: (key: string) => void): void;
+}
+
+// Checks the first tier, then the second, refilling the first on a second-tier hit. With an invalidator, a delete
+// also clears the first tier of every other process
+export class TieredCache<V> implements Cache<V> {
+  constructor(private first: Cache<V>, private second: Cache<V>, private invalidator?: Invalidator) {
+    invalidator?.subscribe((key) => void this.first.delete(key));
+  }
+
+  async get(key: string): Promise<V | undefined> {
+    const value = await this.first.get(key);
+    if (value !== undefined) return value;
+    const shared = await this.second.get(key);
+    if (shared !== undefined) await this.first.set(key, shared);
+    return shared;
+  }
+
+  async set(key: string, value: V): Promise<void> {
+    await Promise.all([this.first.set(key, value), this.second.set(key, value)]);
+  }
 
-export interface Create${Feature}Dto {
-  $dto_fields
+  async delete(key: string): Promise<void> {
+    await Promise.all([this.first.delete(key), this.second.delete(key)]);
+    await this.invalidator?.publish(key);
+  }
 }
 
-@injectable()
-export class Create${Feature}UseCase {
-  constructor(@inject('${Feature}Repository') private ${feature}Repository: ${Feature}Repository) {}
+// Read-through with single-flight: concurrent misses for a key share one load, and only Ok, non-null results are cached
+export class ReadThroughCache<V> {
+  private inFlight = new Map<string, Promise<unknown>>();
+
+  constructor(private cache: Cache<V>) {}
+
+  async get<E>(key: string, load: () => Promise<Result<V | null, E>>): Promise<Result<V | null, E>> {
+    const pending = this.inFlight.get(key) as Promise<Result<V | null, E>> | undefined;
+    if (pending) return pending;
+    const value = await this.cache.get(key);
+    if (value !== undefined) return Ok(value);
+    // Another caller may have started the load while the cache lookup was pending
+    const joined = this.inFlight.get(key) as Promise<Result<V | null, E>> | undefined;
+    if (joined) return joined;
+    const loading: Promise<Result<V | null, E>> = load()
+      .then(async (result) => {
+        // Skip the write if invalidate() ran while loading: the result may predate that write
+        const value = result.isOk() ? result.unwrap() : null;
+        if (value !== null && this.inFlight.get(key) === loading) await this.cache.set(key, value);
+        return result;
+      })
+      .finally(() => {
+        if (this.inFlight.get(key) === loading) this.inFlight.delete(key);
+      });
+    this.inFlight.set(key, loading);
+    return loading;
+  }
+
+  async invalidate(key: string): Promise<void> {
+    this.inFlight.delete(key);
+    await this.cache.delete(key);
+  }
 
-  async execute(dto: Create${Feature}Dto): Promise<Result<$Feature, CustomError>> {
-    const ${feature} = new $Feature(
-      Math.random().toString(36).substring(2), // Simple ID generation
-      $(for name in "${field_names[@]}"; do echo "dto.$name,"; done | tr '\n' ' ')
-    );
-    return await this.${feature}Repository.create(${feature});
+  // Write-through after an update: the delete clears other processes' copies, then the new value is stored
+  async put(key: string, value: V): Promise<void> {
+    await this.invalidate(key);
+    await this.cache.set(key, value);
   }
 }
 EOL
-    echo "Created Features/$feature/domain/usecases/create-$feature.usecase.ts"
+    echo "Created Core/cache/cache.ts"
+fi
+if [[ " ${CACHES[*]} " == *" redis "* ]]; then
+    cat > Core/cache/redis-cache.ts << EOL
+import { randomUUID } from 'node:crypto';
+import Redis from 'ioredis';
+import { Cache, Invalidator } from './cache';
 
-    # Create Features/<feature>/data/models/<feature>.model.ts
-    cat > "Features/$feature/data/models/$feature.model.ts" << EOL
-import mongoose, { Schema, Document } from 'mongoose';
+let client: Redis | null = null;
 
-export interface I$Feature extends Document {
-  id: string;
-  $entity_fields
-}
+// One connection per process, opened on first use so REDIS_URL is read after dotenv has run
+const getRedis = (): Redis => {
+  if (!client) {
+    client = new Redis(process.env.REDIS_URL || 'redis://localhost:6379', { maxRetriesPerRequest: 1 });
+    client.on('error', (error) => console.error('Redis error:', error.message));
+  }
+  return client;
+};
 
-const ${Feature}Schema: Schema = new Schema({
-  id: { type: String, required: true, unique: true },
-  $model_fields
-});
+// Shared second tier; Redis failures are treated as misses so reads fall back to MongoDB
+export class RedisCache<V> implements Cache<V> {
+  constructor(private namespace: string, private ttlMs: number, private revive: (raw: V) => V) {}
 
-export const ${Feature}Model = mongoose.model<I$Feature>('$Feature', ${Feature}Schema);
-EOL
-    echo "Created Features/$feature/data/models/$feature.model.ts"
+  async get(key: string): Promise<V | undefined> {
+    try {
+      const raw = await getRedis().get(this.namespace + ':' + key);
+      return raw === null ? undefined : this.revive(JSON.parse(raw));
+    } catch {
+      return undefined;
+    }
+  }
 
-    # Create Features/<feature>/data/datasources/<feature>.datasource.ts
-    cat > "Features/$feature/data/datasources/$feature.datasource.ts" << EOL
-import { injectable } from 'tsyringe';
-import { $Feature } from '../../domain/entity/$feature.entity';
-import { ${Feature}Model } from '../models/$feature.model';
-import { Result, Ok, Err } from '../../../../Core/result/result';
-import { CustomError } from '../../../../Core/error/custom-error';
-
-@injectable()
-export class ${Feature}DataSource {
-  async create(${feature}: $Feature): Promise<Result<$Feature, CustomError>> {
+  async set(key: string, value: V): Promise<void> {
     try {
-      const ${feature}Doc = new ${Feature}Model(${feature});
-      await ${feature}Doc.save();
-      return Ok(${feature});
-    } catch (error) {
-      return Err(new CustomError(500, 'Failed to create ${feature}: ' + (error as Error).message));
+      await getRedis().set(this.namespace + ':' + key, JSON.stringify(value), 'PX', this.ttlMs);
+    } catch {
+      // A missed cache write only costs a later MongoDB read
     }
   }
 
-  async findById(id: string): Promise<Result<$Feature | null, CustomError>> {
+  async delete(key: string): Promise<void> {
     try {
-      const ${feature}Doc = await ${Feature}Model.findOne({ id });
-      if (!${feature}Doc) return Ok(null);
-      return Ok(new $Feature(${feature}Doc.id, $(for name in "${field_names[@]}"; do echo "${feature}Doc.$name,"; done | tr '\n' ' ')));
-    } catch (error) {
-      return Err(new CustomError(500, 'Failed to find ${feature}: ' + (error as Error).message));
+      await getRedis().del(this.namespace + ':' + key);
+    } catch {
+      // Entries that could not be deleted still expire after ttlMs
     }
   }
 }
-EOL
-    echo "Created Features/$feature/data/datasources/$feature.datasource.ts"
 
-    # Create Features/<feature>/data/repositories/<feature>.repository.ts
-    cat > "Features/$feature/data/repositories/$feature.repository.ts" << EOL
-import { injectable, inject } from 'tsyringe';
-import { $Feature } from '../../domain/entity/$feature.entity';
-import { ${Feature}Repository } from '../../domain/repositories/$feature.repository.interface';
-import { ${Feature}DataSource } from '../datasources/$feature.datasource';
-import { Result } from '../../../../Core/result/result';
-import { CustomError } from '../../../../Core/error/custom-error';
+const INVALIDATION_CHANNEL = 'cache:invalidate';
+const origin = randomUUID();
+const listeners = new Map<string, ((key: string) => void)[]>();
+let subscriber: Redis | null = null;
 
-@injectable()
-export class ${Feature}RepositoryImpl implements ${Feature}Repository {
-  constructor(@inject('${Feature}DataSource') private dataSource: ${Feature}DataSource) {}
+// Pub/sub of changed keys, so every process drops them from its memory tier. Delivery is at most once: a process that
+// misses a message (e.g. while reconnecting) serves its copy until CACHE_MEMORY_TTL_MS expires it. A subscribed
+// connection can run no other commands, so listening takes a second connection, opened on first use.
+export class RedisInvalidator implements Invalidator {
+  constructor(private namespace: string) {}
 
-  async create(${feature}: $Feature): Promise<Result<$Feature, CustomError>> {
-    return await this.dataSource.create(${feature});
+  async publish(key: string): Promise<void> {
+    try {
+      await getRedis().publish(INVALIDATION_CHANNEL, JSON.stringify([origin, this.namespace, key]));
+    } catch {
+      // The other processes' copies still expire after CACHE_MEMORY_TTL_MS
+    }
   }
 
-  async findById(id: string): Promise<Result<$Feature | null, CustomError>> {
-    return await this.dataSource.findById(id);
+  subscribe(listener: (key: string) => void): void {
+    listeners.set(this.namespace, [...(listeners.get(this.namespace) ?? []), listener]);
+    if (subscriber) return;
+    subscriber = new Redis(process.env.REDIS_URL || 'redis://localhost:6379');
+    subscriber.on('error', (error) => console.error('Redis subscriber error:', error.message));
+    subscriber.subscribe(INVALIDATION_CHANNEL).catch(() => undefined);
+    subscriber.on('message', (channel, message) => {
+      const [sender, namespace, key] = JSON.parse(message) as [string, string, string];
+      if (sender !== origin) listeners.get(namespace)?.forEach((notify) => notify(key));
+    });
   }
 }
 EOL
-    echo "Created Features/$feature/data/repositories/$feature.repository.ts"
-
-    # Create Features/<feature>/delivery/middlewares/validate-<feature>.middleware.ts
-    cat > "Features/$feature/delivery/middlewares/validate-$feature.middleware.ts" << EOL
-import { Request, Response, NextFunction } from 'express';
-import { z } from 'zod';
-import { CustomError } from '../../../Core/error/custom-error';
-
-const ${feature}Schema = $zod_schema;
+    echo "Created Core/cache/redis-cache.ts"
+    if [ "$COMMAND" = "feature" ] && ! grep -q '"ioredis"' package.json; then
+        add_packages --save ioredis@^5.4.1
+    fi
+fi
 
-export const validate${Feature} = (req: Request, res: Response, next: NextFunction) => {
-  try {
-    ${feature}Schema.parse(req.body);
-    next();
-  } catch (error) {
-    if (error instanceof z.ZodError) {
-      throw new CustomError(400, error.errors.map(e => e.message).join(', '));
-    }
-    throw new CustomError(500, 'Validation error');
-  }
+# Create Core/http/version.ts (also for projects generated before it existed)
+if [ "$COMMAND" != "feature" ] || [ ! -f Core/http/version.ts ]; then
+    mkdir -p Core/http
+    cat > Core/http/version.ts << EOL
+// The version a client expects the entity to be at, from an If-Match header holding the "version" of an earlier
+// response (3, "3" or W/"3"): undefined without the header, so the write is unconditional, and NaN if it is no version
+export const ifMatchVersion = (header: string | string[] | undefined): number | undefined => {
+  if (header === undefined) return undefined;
+  const value = (Array.isArray(header) ? header[0] : header).trim().replace(/^W\//, '').replace(/^"(.*)"\$/, '\$1');
+  return /^\d+\$/.test(value) ? Number(value) : NaN;
 };
 EOL
-    echo "Created Features/$feature/delivery/middlewares/validate-$feature.middleware.ts"
+    echo "Created Core/http/version.ts"
+fi
 
-    # Create Features/<feature>/delivery/controllers/<feature>.controller.ts
-    cat > "Features/$feature/delivery/controllers/$feature.controller.ts" << EOL
-import { injectable, inject } from 'tsyringe';
-import { Request, Response, NextFunction } from 'express';
-import { Router } from 'express';
-import { Create${Feature}UseCase, Create${Feature}Dto } from '../../domain/usecases/create-$feature.usecase';
-import { CustomError } from '../../../Core/error/custom-error';
-import { validate${Feature} } from '../middlewares/validate-$feature.middleware';
+# Create Core/serverless/*.ts for --target lambda: the request model the feature handlers answer, and the MongoDB
+# connection the entry point opens
+if [ "$TARGET" != "server" ]; then
+    mkdir -p Core/serverless
+    cat > Core/serverless/http.ts << EOL
+import { CustomError } from '../error/custom-error';
+import { Result, Ok, Err } from '../result/result';
 
-@injectable()
-export class ${Feature}Controller {
-  private router: Router;
+// A platform-neutral HTTP exchange: $SERVER_ENTRY turns the platform's request into an HttpRequest and the
+// HttpResponse back, so the feature handlers in Features/<feature>/delivery/handlers know nothing about either
+export interface HttpRequest {
+  method: string;
+  path: string;
+  query: Record<string, string | undefined>;
+  // Header names are lower case
+  headers: Record<string, string | undefined>;
+  body: string;
+}
 
-  constructor(@inject('Create${Feature}UseCase') private create${Feature}UseCase: Create${Feature}UseCase) {
-    this.router = Router();
-    this.router.post('/', validate${Feature}, this.create${Feature}.bind(this));
-  }
+export interface HttpResponse {
+  statusCode: number;
+  headers: Record<string, string>;
+  body: string;
+}
 
-  async create${Feature}(req: Request, res: Response): Promise<void> {
-    const dto: Create${Feature}Dto = req.body;
-    const result = await this.create${Feature}UseCase.execute(dto);
-    if (result.isOk()) {
-      res.status(201).json(result.unwrap());
-    } else {
-      const error = result.unwrapErr();
-      res.status(error.statusCode).json({ message: error.message });
-    }
+// Answers the requests below /api/<feature>, with route the path after that prefix ('/' for the prefix itself);
+// null means no route matches
+export interface FeatureHandler {
+  handle(request: HttpRequest, route: string): Promise<HttpResponse | null>;
+}
+
+export const jsonResponse = (statusCode: number, body: string): HttpResponse => ({
+  statusCode,
+  headers: { 'content-type': 'application/json; charset=utf-8' },
+  body,
+});
+
+export const emptyResponse = (statusCode: number): HttpResponse => ({ statusCode, headers: {}, body: '' });
+
+export const errorResponse = (error: CustomError): HttpResponse =>
+  jsonResponse(error.statusCode, JSON.stringify({ message: error.message }));
+
+// An empty body parses to {}, as it does on the server, so validation reports the missing fields
+export const parseJson = (request: HttpRequest): Result<unknown, CustomError> => {
+  if (request.body.trim() === '') return Ok({});
+  try {
+    return Ok(JSON.parse(request.body));
+  } catch {
+    return Err(new CustomError(400, 'body is not valid JSON'));
   }
+};
 
-  getRouter(): Router {
-    return this.router;
+// Routes a request to the handler of the feature named in /api/<feature>, rendering errors the way
+// Core/error/error-handler does on the server
+export const dispatch = async (handlers: Map<string, FeatureHandler>, request: HttpRequest): Promise<HttpResponse> => {
+  if (request.method === 'GET' && request.path === '/health/live') return jsonResponse(200, '{"status":"ok"}');
+  const match = /^\/api\/([^/]+)(\/.*)?\$/.exec(request.path);
+  const handler = match ? handlers.get(match[1]) : undefined;
+  try {
+    const response = handler && match ? await handler.handle(request, match[2] || '/') : null;
+    return response ?? errorResponse(new CustomError(404, 'Cannot ' + request.method + ' ' + request.path));
+  } catch (error) {
+    if (error instanceof CustomError) return errorResponse(error);
+    // A malformed percent-encoding in the id
+    if (error instanceof URIError) return errorResponse(new CustomError(400, error.message));
+    console.error('Unhandled error:', error);
+    return errorResponse(new CustomError(500, 'Internal server error'));
   }
-}
+};
 EOL
-    echo "Created Features/$feature/delivery/controllers/$feature.controller.ts"
+    echo "Created Core/serverless/http.ts"
 
-    # Create __tests__/Features/<feature>/<feature>.usecase.test.ts
-    cat > "__tests__/Features/$feature/$feature.usecase.test.ts" << EOL
-import { container } from 'tsyringe';
-import { Create${Feature}UseCase, Create${Feature}Dto } from '../../../Features/$feature/domain/usecases/create-$feature.usecase';
-import { ${Feature}Repository } from '../../../Features/$feature/domain/repositories/$feature.repository.interface';
-import { Result, Ok, Err } from '../../../Core/result/result';
-import { CustomError } from '../../../Core/error/custom-error';
-import { $Feature } from '../../../Features/$feature/domain/entity/$feature.entity';
-
-describe('Create${Feature}UseCase', () => {
-  let create${Feature}UseCase: Create${Feature}UseCase;
-  let mockRepository: jest.Mocked<${Feature}Repository>;
-
-  beforeEach(() => {
-    mockRepository = {
-      create: jest.fn(),
-      findById: jest.fn(),
-    };
-    container.registerInstance('${Feature}Repository', mockRepository);
-    create${Feature}UseCase = container.resolve<Create${Feature}UseCase>('Create${Feature}UseCase');
-  });
+    cat > Core/serverless/connection.ts << EOL
+import { connectToDatabase } from '../config/database';
 
-  afterEach(() => {
-    container.reset();
+// Opened by the first invocation of an instance and kept at module scope, so warm invocations reuse the connection
+// and its pool. A failed attempt is forgotten and the next invocation retries it.
+let connecting: Promise<void> | null = null;
+
+export const ensureDatabase = (): Promise<void> => {
+  connecting ??= connectToDatabase().catch((error) => {
+    connecting = null;
+    throw error;
   });
+  return connecting;
+};
+EOL
+    echo "Created Core/serverless/connection.ts"
+fi
 
-  it('should create a $feature successfully', async () => {
-    const dto: Create${Feature}Dto = ${sample_jsons[$i]};
-    const ${feature} = new $Feature('123', $(for name in "${field_names[@]}"; do echo "dto.$name,"; done | tr '\n' ' '));
-    mockRepository.create.mockResolvedValue(Ok(${feature}));
+# Create bench/load/run.ts (also for projects generated before it existed, or before they used the outbox)
+if [ "$COMMAND" != "feature" ] || [ ! -f bench/load/run.ts ] ||
+    { [ "$USES_OUTBOX" = "true" ] && ! grep -q MongoMemoryReplSet bench/load/run.ts; }; then
+    mkdir -p bench/load
+    # Outbox writes are transactions, which need a replica set; the relay stays off as there is no broker to publish to
+    if [ "$USES_OUTBOX" = "true" ]; then
+        bench_mongo="MongoMemoryReplSet"
+        bench_mongo_start="MongoMemoryReplSet.create({ replSet: { count: 1 } })"
+        bench_env=", OUTBOX_RELAY: 'off'"
+    else
+        bench_mongo="MongoMemoryServer"
+        bench_mongo_start="MongoMemoryServer.create()"
+        bench_env=""
+    fi
+    cat > bench/load/run.ts << EOL
+// Load-test runner. Run with: npm run bench
+// Starts an in-memory MongoDB and the built server on BENCH_PORT, runs every scenario exported by bench/load/*.load.ts
+// through autocannon, and writes p50/p99 latency and requests/sec to BENCH_OUTPUT (default bench/results/<commit>.json).
+// Set BENCH_BASELINE to an earlier results file to print the change against it.
+import { spawn, execSync } from 'node:child_process';
+import { existsSync, mkdirSync, readdirSync, readFileSync, writeFileSync } from 'node:fs';
+import path from 'node:path';
+import autocannon from 'autocannon';
+import { $bench_mongo } from 'mongodb-memory-server';
 
-    const result = await create${Feature}UseCase.execute(dto);
+export interface LoadScenario {
+  name: string;
+  method: 'GET' | 'POST';
+  path: string;
+  headers?: Record<string, string>;
+  // A function builds a new body for every request
+  body?: string | (() => string);
+}
 
-    expect(result.isOk()).toBe(true);
-    expect(result.unwrap()).toEqual(${feature});
-    expect(mockRepository.create).toHaveBeenCalledWith(expect.any($Feature));
-  });
+interface ScenarioResult {
+  scenario: string;
+  requestsPerSecond: number;
+  p50Ms: number;
+  p99Ms: number;
+  non2xx: number;
+  errors: number;
+}
 
-  it('should return an error if repository fails', async () => {
-    const dto: Create${Feature}Dto = ${sample_jsons[$i]};
-    const error = new CustomError(500, 'Repository error');
-    mockRepository.create.mockResolvedValue(Err(error));
+const DURATION_S = Number(process.env.BENCH_DURATION_S) || 10;
+const CONNECTIONS = Number(process.env.BENCH_CONNECTIONS) || 50;
+const PORT = Number(process.env.BENCH_PORT) || 3100;
+const BASE_URL = 'http://127.0.0.1:' + PORT;
 
-    const result = await create${Feature}UseCase.execute(dto);
+const commit = (): string => {
+  try {
+    return execSync('git rev-parse --short HEAD', { stdio: ['ignore', 'pipe', 'ignore'] }).toString().trim();
+  } catch {
+    return 'unversioned';
+  }
+};
 
-    expect(result.isErr()).toBe(true);
-    expect(result.unwrapErr()).toEqual(error);
-  });
-});
-EOL
-    echo "Created __tests__/Features/$feature/$feature.usecase.test.ts"
+const waitForReady = async (timeoutMs: number): Promise<void> => {
+  const deadline = Date.now() + timeoutMs;
+  while (Date.now() < deadline) {
+    try {
+      if ((await fetch(BASE_URL + '/health/ready')).ok) return;
+    } catch {
+      // Not listening yet
+    }
+    await new Promise((resolve) => setTimeout(resolve, 200));
+  }
+  throw new Error('Server did not become ready within ' + timeoutMs + 'ms');
+};
 
-    # Create __tests__/Features/<feature>/<feature>.controller.test.ts
-    cat > "__tests__/Features/$feature/$feature.controller.test.ts" << EOL
-import request from 'supertest';
-import express from 'express';
-import { container } from 'tsyringe';
-import { ${Feature}Controller } from '../../../Features/$feature/delivery/controllers/$feature.controller';
-import { Create${Feature}UseCase } from '../../../Features/$feature/domain/usecases/create-$feature.usecase';
-import { Result, Ok } from '../../../Core/result/result';
-import { $Feature } from '../../../Features/$feature/domain/entity/$feature.entity';
-
-describe('${Feature}Controller', () => {
-  let app: express.Application;
-  let mockUseCase: jest.Mocked<Create${Feature}UseCase>;
-
-  beforeEach(() => {
-    mockUseCase = {
-      execute: jest.fn(),
-    };
-    container.registerInstance('Create${Feature}UseCase', mockUseCase);
-    const controller = container.resolve(${Feature}Controller);
-    app = express();
-    app.use(express.json());
-    app.use('/api/$feature', controller.getRouter());
-  });
+const loadScenarios = (): LoadScenario[] =>
+  readdirSync(__dirname)
+    .filter((file) => /\\.load\\.(ts|js)\$/.test(file))
+    .sort()
+    .flatMap((file) => (require(path.join(__dirname, file)) as { scenarios: LoadScenario[] }).scenarios);
 
-  afterEach(() => {
-    container.reset();
+const run = async (scenario: LoadScenario): Promise<ScenarioResult> => {
+  const { body } = scenario;
+  const result = await autocannon({
+    url: BASE_URL + scenario.path,
+    method: scenario.method,
+    headers: scenario.headers,
+    duration: DURATION_S,
+    connections: CONNECTIONS,
+    ...(typeof body === 'function' ? { requests: [{ setupRequest: (request) => ({ ...request, body: body() }) }] } : { body }),
   });
+  return {
+    scenario: scenario.name,
+    requestsPerSecond: result.requests.average,
+    p50Ms: result.latency.p50,
+    p99Ms: result.latency.p99,
+    non2xx: result.non2xx,
+    errors: result.errors + result.timeouts,
+  };
+};
 
-  it('should create a $feature and return 201', async () => {
-    const dto = ${sample_jsons[$i]};
-    const ${feature} = new $Feature('123', $(for name in "${field_names[@]}"; do echo "dto.$name,"; done | tr '\n' ' '));
-    mockUseCase.execute.mockResolvedValue(Ok(${feature}));
-
-    const response = await request(app)
-      .post('/api/$feature')
-      .send(dto)
-      .set('Accept', 'application/json');
+const percentChange = (current: number, previous: number): string =>
+  previous === 0 ? 'n/a' : ((current - previous) / previous * 100).toFixed(1) + '%';
 
-    expect(response.status).toBe(201);
-    expect(response.body).toEqual({
-      id: '123',
-      $(for name in "${field_names[@]}"; do echo "$name: dto.$name,"; done | tr '\n' ' ')
-    });
-    expect(mockUseCase.execute).toHaveBeenCalledWith(dto);
+const main = async () => {
+  const mongo = await $bench_mongo_start;
+  const server = spawn(process.execPath, ['dist/Server/index.js'], {
+    env: { ...process.env, PORT: String(PORT), MONGODB_URI: mongo.getUri('bench'), MONGO_SYNC_INDEXES: 'true'$bench_env },
+    stdio: ['ignore', 'inherit', 'inherit'],
   });
+  try {
+    await waitForReady(30_000);
+    const results: ScenarioResult[] = [];
+    for (const scenario of loadScenarios()) {
+      const result = await run(scenario);
+      results.push(result);
+      console.log(
+        scenario.name.padEnd(24),
+        result.requestsPerSecond.toFixed(0).padStart(8), 'req/s',
+        ('p50 ' + result.p50Ms + 'ms').padStart(12),
+        ('p99 ' + result.p99Ms + 'ms').padStart(12),
+        result.non2xx + result.errors > 0 ? '(' + result.non2xx + ' non-2xx, ' + result.errors + ' errors)' : ''
+      );
+    }
 
-  it('should return 400 for invalid input', async () => {
-    const invalidDto = {};
+    const sha = commit();
+    const output = process.env.BENCH_OUTPUT || path.join('bench', 'results', sha + '.json');
+    mkdirSync(path.dirname(output), { recursive: true });
+    writeFileSync(output, JSON.stringify({ commit: sha, date: new Date().toISOString(), node: process.version, durationSeconds: DURATION_S, connections: CONNECTIONS, results }, null, 2) + '\\n');
+    console.log('Wrote ' + output);
 
-    const response = await request(app)
-      .post('/api/$feature')
-      .send(invalidDto)
-      .set('Accept', 'application/json');
+    const baselineFile = process.env.BENCH_BASELINE;
+    if (baselineFile && existsSync(baselineFile)) {
+      const baseline = JSON.parse(readFileSync(baselineFile, 'utf8')) as { commit: string; results: ScenarioResult[] };
+      console.log('Compared with ' + baseline.commit + ':');
+      for (const result of results) {
+        const previous = baseline.results.find((item) => item.scenario === result.scenario);
+        if (!previous) continue;
+        console.log(
+          result.scenario.padEnd(24),
+          'req/s', percentChange(result.requestsPerSecond, previous.requestsPerSecond).padStart(8),
+          'p99', percentChange(result.p99Ms, previous.p99Ms).padStart(8)
+        );
+      }
+    }
+  } finally {
+    server.kill('SIGTERM');
+    await mongo.stop();
+  }
+};
 
-    expect(response.status).toBe(400);
-    expect(response.body.message).toContain('is required');
-  });
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
 });
 EOL
-    echo "Created __tests__/Features/$feature/$feature.controller.test.ts"
-done
+    echo "Created bench/load/run.ts"
+    if [ "$COMMAND" = "feature" ] && ! grep -q '"autocannon"' package.json; then
+        add_packages --save-dev autocannon@^7.15.0 @types/autocannon@^7.12.5 mongodb-memory-server@^10.1.2
+        npm pkg set scripts.bench="$BENCH_SCRIPT" > /dev/null 2>&1
+    fi
+fi
+phase_done "shared files"
 
 # Create/Update README.md
 readme_content="# $PROJECT_NAME
 
-A TypeScript-based Express API with MongoDB, Mongoose, clean architecture, Zod validation, tsyringe DI, and Jest testing.
+A TypeScript-based $(capitalize "$HTTP_FRAMEWORK") API with MongoDB, Mongoose, clean architecture, Zod validation, tsyringe DI, and Jest testing.
 
 ## Setup
 
@@ -805,20 +4571,49 @@ A TypeScript-based Express API with MongoDB, Mongoose, clean architecture, Zod v
    \`\`\`bash
    npm test
    \`\`\`
+6. Compare the closure and class-based \`Result\` implementations:
+   \`\`\`bash
+   npm run bench:result
+   \`\`\`
+7. Load-test every route against an in-memory MongoDB (results in \`bench/results/<commit>.json\`; set \`BENCH_BASELINE\` to compare with an earlier run):
+   \`\`\`bash
+   npm run bench
+   \`\`\`
 
 ## Testing
 
 $(for i in "${!FEATURES[@]}"; do
     feature="${FEATURES[$i]}"
+    if [ "${KINDS[$i]}" = "readmodel" ]; then
+        echo "- Query the ${feature} read model, or ask for a rebuild from ${SOURCES[$i]} (at most once per \`READMODEL_REFRESH_MIN_INTERVAL_MS\`):"
+        echo "  \`\`\`bash"
+        echo "  curl \"http://localhost:3000/api/${feature}?limit=20\""
+        echo "  curl -X POST http://localhost:3000/api/${feature}/refresh"
+        echo "  \`\`\`"
+        continue
+    fi
     echo "- Create a ${feature}:"
     echo "  \`\`\`bash"
     echo "  curl -X POST http://localhost:3000/api/${feature} -H \"Content-Type: application/json\" -d '${sample_jsons[$i]}'"
     echo "  \`\`\`"
+    echo "- Create many ${feature} in one request (inserted in batches of \`BULK_BATCH_SIZE\`):"
+    echo "  \`\`\`bash"
+    echo "  curl -X POST http://localhost:3000/api/${feature}/bulk -H \"Content-Type: application/json\" -d '[${sample_jsons[$i]}]'"
+    echo "  \`\`\`"
+    echo "- List ${feature} a page at a time (pass the returned \`nextCursor\` back as \`cursor\`):"
+    echo "  \`\`\`bash"
+    echo "  curl \"http://localhost:3000/api/${feature}?limit=20\""
+    echo "  \`\`\`"
+    echo "- Change or delete a ${feature}; with \`If-Match: <version>\` the write fails with 412 if it was modified since:"
+    echo "  \`\`\`bash"
+    echo "  curl -X PATCH http://localhost:3000/api/${feature}/<id> -H \"Content-Type: application/json\" -H \"If-Match: 0\" -d '${sample_jsons[$i]}'"
+    echo "  curl -X DELETE http://localhost:3000/api/${feature}/<id>"
+    echo "  \`\`\`"
 done)
 
 ## Structure
 
-- \`Core/\`: Shared utilities (config, error, result).
+- \`Core/\`: Shared utilities (config, error, health, id, result).
 - \`Features/\`: Feature-specific modules (${FEATURES[*]}).
   - \`domain/\`: Business logic (entities, use cases, repositories).
   - \`data/\`: Data access (models, data sources, repositories).
@@ -830,14 +4625,27 @@ done)
 ## Notes
 
 - Uses \`tsyringe\` for dependency injection and \`zod\` for validation.
+- Each feature has \`bench/<feature>.validation.bench.ts\` comparing the Zod schema with the generated inline validator (\`npx ts-node bench/<feature>.validation.bench.ts\`).$([ "$METRICS" = "true" ] && echo && echo "- \`GET /metrics\` serves Prometheus histograms for controller handlers, use cases and datasource calls, plus event-loop lag, GC pauses and MongoDB pool gauges (per process; scrape each worker in cluster mode). Set \`Metrics.Enabled = 0\` in \`Core/metrics/metrics.ts\` to compile the timing out.")$([ "$PROTECT" = "true" ] && echo && echo "- Routes are rate limited per client (\`RATE_LIMIT_RPS\`, \`RATE_LIMIT_BURST\`, keyed by \`RATE_LIMIT_KEY\`; override one route with \`RATE_LIMIT_<FEATURE>_<ROUTE>_RPS\`) and shed with 503 while more than \`SHED_MAX_IN_FLIGHT\` requests are in flight or event-loop lag exceeds \`SHED_MAX_EVENT_LOOP_LAG_MS\` (\`Core/middleware/overload.ts\`; 0 turns a limit off).")$([ "$TRACING" = "true" ] && echo && echo "- OpenTelemetry spans cover each controller handler, use case, repository and datasource call plus the HTTP server and Mongoose queries, and are exported over OTLP to \`OTEL_EXPORTER_OTLP_ENDPOINT\`. \`TRACE_SAMPLE_RATIO\` (default 0.1) sets the share of new traces recorded.")$([ "$BUILD" = "esbuild" ] && echo && echo "- \`npm run build\` bundles the server into one minified \`dist/Server/index.js\` with esbuild (\`build.mjs\`), and \`npm run dev\` runs it with \`tsx watch\`. Neither type checks: run \`npm run typecheck\`. DI resolves every dependency by its \`@inject\` token, so no decorator metadata is emitted.")$([ "$TARGET" = "lambda" ] && echo && echo "- \`Server/lambda.ts\` serves the feature routes (all but \`POST /import\`) on AWS Lambda behind an API Gateway HTTP API or a function URL: after \`npm run build\`, the handler is \`dist/Server/lambda.handler\`. Each cold start connects to MongoDB and builds the DI graph once, and warm invocations reuse both, so set \`MONGO_POOL_MIN=0\` and a small \`MONGO_POOL_MAX\` in the function's environment. Read models and the outbox relay need \`Server/index.ts\`.")
+- MongoDB pool size, timeouts, wire compression and read preference come from the \`MONGO_*\` settings in \`.env\`; \`GET /health/ready\` reports the connection and pool state (503 while disconnected or when the pool is exhausted).
+$(for i in "${!FEATURES[@]}"; do
+    [ "${OFFLOADS[$i]}" = "worker" ] && echo "- \`${FEATURES[$i]}\` runs its create input through \`prepare$(capitalize "${FEATURES[$i]}")\` in \`Features/${FEATURES[$i]}/domain/workers/${FEATURES[$i]}.task.ts\` on the \`Core/workers\` thread pool (\`WORKER_POOL_SIZE\`, \`WORKER_POOL_MAX_QUEUE\`); put CPU-heavy steps there."
+    [ "${OUTBOXES[$i]}" = "true" ] && echo "- \`${FEATURES[$i]}\` writes each create and an \`${FEATURES[$i]}.created\` event to the \`outbox\` collection in one transaction (MongoDB must run as a replica set). \`Core/outbox/relay.ts\` publishes the events to the Redis stream \`events:${FEATURES[$i]}.created\` (prefix \`OUTBOX_STREAM_PREFIX\`), at least once and in order; set \`OUTBOX_RELAY=off\` on all but one instance."
+    [ "${KINDS[$i]}" = "readmodel" ] && echo "- \`${FEATURES[$i]}\` is a read model of \`${SOURCES[$i]}\`, rebuilt every \`READMODEL_REBUILD_MS\` and refreshed from a change stream in between (replica sets only; enable \`changeStreamPreAndPostImages\` on the source collection to make deletes incremental too). \`POST /api/${FEATURES[$i]}/refresh\` records a rebuild request that the projector runs within \`READMODEL_REQUEST_POLL_MS\`, and answers 429 within \`READMODEL_REFRESH_MIN_INTERVAL_MS\` of the last one. Set \`READMODEL_REFRESH=off\` on instances that should only serve it."
+    [ "${REPLICA_READS[$i]}" = "true" ] && echo "- \`${FEATURES[$i]}\` sends its by-id and list reads to replica set secondaries (\`MONGO_REPLICA_READ_PREFERENCE\`, or \`MONGO_$(printf '%s' "${FEATURES[$i]}" | tr '[:lower:]' '[:upper:]')_READ_PREFERENCE\` for this feature alone), skipping any that lag by more than \`MONGO_REPLICA_MAX_STALENESS_SECONDS\`; writes go to the primary, so a read right after a write may not see it yet."
+    [ "${CACHES[$i]}" = "none" ] || echo "- \`${FEATURES[$i]}\` reads by id through a ${CACHES[$i]} read-through cache (\`CACHE_*\` in \`.env\`); see \`Features/${FEATURES[$i]}/data/datasources/${FEATURES[$i]}.cached.datasource.ts\`."
+done)
 - Run \`npm test\` to execute unit and integration tests.
 - Ensure MongoDB is running for integration tests.
 "
 echo "$readme_content" > README.md
 echo "Created/Updated README.md"
+phase_done "readme"
 
 echo "Project setup complete!"
-if [ "$COMMAND" = "feature" ]; then
+if [ "$APPLY" = "true" ]; then
+    printf '%s\n' "${FEATURES[@]}" | paste -d= - <(printf '%s\n' "${applied_hashes[@]}") > .tsclean-apply
+    echo "Applied $MANIFEST ($changed_count of ${#FEATURES[@]} features generated)"
+elif [ "$COMMAND" = "feature" ]; then
     echo "Feature '${FEATURES[0]}' added to $PROJECT_NAME"
 else
     echo "To start the development server, run:"
@@ -846,4 +4654,10 @@ else
     echo "To run tests, run:"
     echo "  npm test"
 fi
-echo "Ensure MongoDB is running and update .env with the correct MONGODB_URI if needed."
\ No newline at end of file
+echo "Ensure MongoDB is running and update .env with the correct MONGODB_URI if needed."
+if [ "$TIMINGS" = "true" ]; then
+    echo "Timings:"
+    for i in "${!PHASE_NAMES[@]}"; do
+        printf '  %-24s %6d.%03d ms\n' "${PHASE_NAMES[$i]}" $((PHASE_MICROS[i] / 1000)) $((PHASE_MICROS[i] % 1000))
+    done
+fi
\ No newline at end of file